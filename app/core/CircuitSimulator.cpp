@@ -72,8 +72,9 @@ void CircuitSimulator::runDcAnalysis(circuitx::Circuit circuit) {
         nodeVoltages[nodeOrder[i]] = solution(static_cast<Eigen::Index>(i));
     }
 
+    // Element terminals keep their original node IDs; wires merge them into supernodes.
     auto voltageAt = [&](unsigned int nodeId) {
-        if (auto it = nodeVoltages.find(nodeId); it != nodeVoltages.end()) {
+        if (auto it = nodeVoltages.find(circuit.supernodeOf(nodeId)); it != nodeVoltages.end()) {
             return it->second;
         }
         return 0.0;
@@ -197,3 +198,12 @@ void CircuitSimulator::runDcAnalysis(circuitx::Circuit circuit) {
 void CircuitSimulator::runTransient(CircuitService& service, double durationSeconds, double timestepSeconds) {
     transientSimulation = service.simulateTransient(durationSeconds, timestepSeconds);
 }
+
+void CircuitSimulator::runDcSweep(CircuitService& service, const ComponentView& component,
+    double start, double stop, double step) {
+    dcSweep = service.sweepDc(component.type, component.nodeA, component.nodeB, start, stop, step);
+}
+
+void CircuitSimulator::runSensitivity(CircuitService& service, unsigned int outputNodeId) {
+    sensitivity = service.analyzeSensitivity(outputNodeId);
+}
@@ -6,6 +6,7 @@
 #define CIRCUITX_CIRCUITSIMULATOR_H
 
 #include "../services/CircuitService.h"
+#include "../services/CircuitView.h"
 #include "../services/SimulationResult.h"
 
 class CircuitSimulator {
@@ -14,13 +15,19 @@ public:
 
     void runDcAnalysis(circuitx::Circuit circuit);
     void runTransient(CircuitService& service, double durationSeconds, double timestepSeconds);
+    void runDcSweep(CircuitService& service, const ComponentView& component, double start, double stop, double step);
+    void runSensitivity(CircuitService& service, unsigned int outputNodeId);
 
     const SimulationResult& dcResult() const { return simulationResult; }
     const TransientResult& transientResult() const { return transientSimulation; }
+    const DcSweepResult& dcSweepResult() const { return dcSweep; }
+    const SensitivityResult& sensitivityResult() const { return sensitivity; }
 
 private:
     SimulationResult simulationResult;
     TransientResult transientSimulation;
+    DcSweepResult dcSweep;
+    SensitivityResult sensitivity;
 };
 
 #endif //CIRCUITX_CIRCUITSIMULATOR_H
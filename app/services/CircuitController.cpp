@@ -18,3 +18,11 @@ void CircuitController::simulate() {
 void CircuitController::simulateTransient(double durationSeconds, double timestepSeconds) {
     simulator.runTransient(editor.getService(), durationSeconds, timestepSeconds);
 }
+
+void CircuitController::sweepDc(const ComponentView& component, double start, double stop, double step) {
+    simulator.runDcSweep(editor.getService(), component, start, stop, step);
+}
+
+void CircuitController::analyzeSensitivity(unsigned int outputNodeId) {
+    simulator.runSensitivity(editor.getService(), outputNodeId);
+}
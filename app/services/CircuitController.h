@@ -15,6 +15,8 @@ public:
     void handle(const CircuitCommand& command);
     void simulate();
     void simulateTransient(double durationSeconds, double timestepSeconds);
+    void sweepDc(const ComponentView& component, double start, double stop, double step);
+    void analyzeSensitivity(unsigned int outputNodeId);
 
     void deleteWire(const WireView& wire) { editor.deleteWire(wire); }
     bool rotateComponent(unsigned int componentId, int rotationDelta) { return editor.rotateComponent(componentId, rotationDelta); }
@@ -35,6 +37,8 @@ public:
     const std::string& getTopology() const { return editor.topology(); }
     const SimulationResult& fetchSimulationResults() const { return simulator.dcResult(); }
     const TransientResult& fetchTransientResult() const { return simulator.transientResult(); }
+    const DcSweepResult& fetchDcSweepResult() const { return simulator.dcSweepResult(); }
+    const SensitivityResult& fetchSensitivityResult() const { return simulator.sensitivityResult(); }
     bool hasSelectableAt(sf::Vector2f position) const { return editor.hasSelectableAt(position); }
 
 private:
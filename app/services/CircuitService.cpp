@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <sstream>
+#include <type_traits>
 
 std::string makeNodeName(unsigned int id) {
     std::ostringstream oss;
@@ -51,52 +52,47 @@ unsigned int CircuitService::addComponent(ComponentType type, unsigned int nodeA
 }
 
 void CircuitService::removeComponent(ComponentType type, unsigned int nodeA, unsigned int nodeB) {
-    auto& elements = circuit.elementsMutable();
-    elements.erase(std::remove_if(elements.begin(), elements.end(), [&](const circuitx::Element& elem) {
-                       switch (type) {
-                           case ComponentType::Resistor:
-                               if (const auto* res = std::get_if<circuitx::Res>(&elem)) {
-                                   return (res->a == nodeA && res->b == nodeB) || (res->a == nodeB && res->b == nodeA);
-                               }
-                               break;
-                           case ComponentType::Capacitor:
-                               if (const auto* cap = std::get_if<circuitx::Cap>(&elem)) {
-                                   return (cap->a == nodeA && cap->b == nodeB) || (cap->a == nodeB && cap->b == nodeA);
-                               }
-                               break;
-                           case ComponentType::ISource:
-                               if (const auto* isrc = std::get_if<circuitx::ISource>(&elem)) {
-                                   return (isrc->a == nodeA && isrc->b == nodeB) || (isrc->a == nodeB && isrc->b == nodeA);
-                               }
-                               break;
-                           case ComponentType::VSource:
-                               if (const auto* vsrc = std::get_if<circuitx::VSource>(&elem)) {
-                                   return (vsrc->a == nodeA && vsrc->b == nodeB) || (vsrc->a == nodeB && vsrc->b == nodeA);
-                               }
-                               break;
-                           case ComponentType::Wire:
-                               if (const auto* wire = std::get_if<circuitx::Wire>(&elem)) {
-                                   return (wire->a == nodeA && wire->b == nodeB) || (wire->a == nodeB && wire->b == nodeA);
-                               }
-                               break;
-                       }
-                       return false;
-                   }),
-        elements.end());
+    circuit.removeElementsIf([&](const circuitx::Element& elem) {
+        switch (type) {
+            case ComponentType::Resistor:
+                if (const auto* res = std::get_if<circuitx::Res>(&elem)) {
+                    return (res->a == nodeA && res->b == nodeB) || (res->a == nodeB && res->b == nodeA);
+                }
+                break;
+            case ComponentType::Capacitor:
+                if (const auto* cap = std::get_if<circuitx::Cap>(&elem)) {
+                    return (cap->a == nodeA && cap->b == nodeB) || (cap->a == nodeB && cap->b == nodeA);
+                }
+                break;
+            case ComponentType::ISource:
+                if (const auto* isrc = std::get_if<circuitx::ISource>(&elem)) {
+                    return (isrc->a == nodeA && isrc->b == nodeB) || (isrc->a == nodeB && isrc->b == nodeA);
+                }
+                break;
+            case ComponentType::VSource:
+                if (const auto* vsrc = std::get_if<circuitx::VSource>(&elem)) {
+                    return (vsrc->a == nodeA && vsrc->b == nodeB) || (vsrc->a == nodeB && vsrc->b == nodeA);
+                }
+                break;
+            case ComponentType::Wire:
+                if (const auto* wire = std::get_if<circuitx::Wire>(&elem)) {
+                    return (wire->a == nodeA && wire->b == nodeB) || (wire->a == nodeB && wire->b == nodeA);
+                }
+                break;
+        }
+        return false;
+    });
 }
 
 void CircuitService::removeNode(unsigned int nodeId) {
-    auto& elements = circuit.elementsMutable();
-    elements.erase(std::remove_if(elements.begin(), elements.end(), [&](const circuitx::Element& elem) {
-                       if (const auto* wire = std::get_if<circuitx::Wire>(&elem)) {
-                           return wire->a == nodeId || wire->b == nodeId;
-                       }
-                       return false;
-                   }),
-        elements.end());
-
-    auto& nodes = circuit.nodesMutable();
-    nodes.erase(std::remove_if(nodes.begin(), nodes.end(), [&](const circuitx::Node& node) { return node.id == nodeId; }), nodes.end());
+    circuit.removeElementsIf([&](const circuitx::Element& elem) {
+        if (const auto* wire = std::get_if<circuitx::Wire>(&elem)) {
+            return wire->a == nodeId || wire->b == nodeId;
+        }
+        return false;
+    });
+
+    circuit.removeNode(nodeId);
 }
 
 std::optional<float> CircuitService::getComponentValue(ComponentType type, unsigned int nodeA, unsigned int nodeB) const {
@@ -144,53 +140,56 @@ std::optional<float> CircuitService::getComponentValue(ComponentType type, unsig
 }
 
 bool CircuitService::updateComponentValue(ComponentType type, unsigned int nodeA, unsigned int nodeB, float value) {
+    const auto index = findElementIndex(type, nodeA, nodeB);
+    return index.has_value() && circuit.setElementValue(*index, value);
+}
+
+std::optional<std::size_t> CircuitService::findElementIndex(ComponentType type, unsigned int nodeA, unsigned int nodeB) const {
     auto matches = [&](unsigned int first, unsigned int second) {
         return (first == nodeA && second == nodeB) || (first == nodeB && second == nodeA);
     };
 
-    auto& elements = circuit.elementsMutable();
-    for (auto& elem : elements) {
-        switch (type) {
-            case ComponentType::Resistor:
-                if (auto* res = std::get_if<circuitx::Res>(&elem)) {
-                    if (matches(res->a, res->b)) {
-                        res->res = value;
-                        return true;
-                    }
-                }
-                break;
-            case ComponentType::Capacitor:
-                if (auto* cap = std::get_if<circuitx::Cap>(&elem)) {
-                    if (matches(cap->a, cap->b)) {
-                        cap->cap = value;
-                        return true;
-                    }
-                }
-                break;
-            case ComponentType::ISource:
-                if (auto* isrc = std::get_if<circuitx::ISource>(&elem)) {
-                    if (matches(isrc->a, isrc->b)) {
-                        isrc->cur = value;
-                        return true;
-                    }
-                }
-                break;
-            case ComponentType::VSource:
-                if (auto* vsrc = std::get_if<circuitx::VSource>(&elem)) {
-                    if (matches(vsrc->a, vsrc->b)) {
-                        vsrc->vol = value;
-                        return true;
-                    }
+    const auto& elements = circuit.elementsView();
+    for (std::size_t idx = 0; idx < elements.size(); ++idx) {
+        const bool found = std::visit(
+            [&](const auto& component) {
+                using T = std::decay_t<decltype(component)>;
+                if constexpr (std::is_same_v<T, circuitx::Res>) {
+                    return type == ComponentType::Resistor && matches(component.a, component.b);
+                } else if constexpr (std::is_same_v<T, circuitx::Cap>) {
+                    return type == ComponentType::Capacitor && matches(component.a, component.b);
+                } else if constexpr (std::is_same_v<T, circuitx::ISource>) {
+                    return type == ComponentType::ISource && matches(component.a, component.b);
+                } else if constexpr (std::is_same_v<T, circuitx::VSource>) {
+                    return type == ComponentType::VSource && matches(component.a, component.b);
+                } else {
+                    return type == ComponentType::Wire && matches(component.a, component.b);
                 }
-                break;
-            case ComponentType::Wire:
-                break;
+            },
+            elements[idx]);
+        if (found) {
+            return idx;
         }
     }
 
-    return false;
+    return std::nullopt;
 }
 
 circuitx::TransientResult CircuitService::simulateTransient(double durationSeconds, double timestepSeconds) {
     return circuit.simulateTransient(durationSeconds, timestepSeconds);
 }
+
+circuitx::DcSweepResult CircuitService::sweepDc(ComponentType type, unsigned int nodeA, unsigned int nodeB,
+    double start, double stop, double step) {
+    auto index = findElementIndex(type, nodeA, nodeB);
+    if (!index) {
+        return {};
+    }
+    return circuit.sweepDc(circuitx::DcSweep::linear(*index, start, stop, step));
+}
+
+circuitx::SensitivityResult CircuitService::analyzeSensitivity(unsigned int outputNodeId) {
+    circuitx::SensitivityOptions options;
+    options.outputNodeId = outputNodeId;
+    return circuit.analyzeSensitivity(options);
+}
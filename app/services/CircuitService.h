@@ -36,6 +36,10 @@ public:
     std::optional<float> getComponentValue(ComponentType type, unsigned int nodeA, unsigned int nodeB) const;
     bool updateComponentValue(ComponentType type, unsigned int nodeA, unsigned int nodeB, float value);
     circuitx::TransientResult simulateTransient(double durationSeconds, double timestepSeconds);
+    circuitx::DcSweepResult sweepDc(ComponentType type, unsigned int nodeA, unsigned int nodeB,
+        double start, double stop, double step);
+    circuitx::SensitivityResult analyzeSensitivity(unsigned int outputNodeId);
+    std::optional<std::size_t> findElementIndex(ComponentType type, unsigned int nodeA, unsigned int nodeB) const;
 
     const circuitx::Circuit& getCircuit() const { return circuit; }
     circuitx::Circuit getCircuit() { return circuit; }
@@ -50,5 +50,7 @@ struct SimulationResult {
 };
 
 using TransientResult = circuitx::TransientResult;
+using DcSweepResult = circuitx::DcSweepResult;
+using SensitivityResult = circuitx::SensitivityResult;
 
 #endif //SIMULATIONRESULT_H
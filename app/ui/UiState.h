@@ -61,6 +61,20 @@ struct TransientState {
     std::vector<float> currentBuffer;
 };
 
+struct DcSweepState {
+    unsigned int sweptComponentId = 0;
+    float start = 0.0f;
+    float stop = 10.0f;
+    float step = 0.5f;
+    int selectedNodeIdx = -1;
+    std::vector<float> voltageBuffer;
+};
+
+struct SensitivityState {
+    unsigned int outputNodeId = 0;
+    bool hasOutput = false;
+};
+
 struct UiState {
     UiTheme theme = UiTheme::Black;
     int placementRotationSteps = 0;
@@ -69,6 +83,8 @@ struct UiState {
     SelectionState selection;
     PropertiesState properties;
     TransientState transient;
+    DcSweepState dcSweep;
+    SensitivityState sensitivity;
 };
 
 #endif //CIRCUITX_UISTATE_H
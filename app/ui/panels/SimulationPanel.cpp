@@ -10,6 +10,7 @@
 #include <limits>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 SimulationPanel::SimulationPanel(CircuitController& controller)
@@ -91,6 +92,8 @@ void SimulationPanel::draw(UiState& uiState) {
     }
 
     drawTransient(uiState, circuitController.fetchTransientResult());
+    drawDcSweep(uiState, circuitController.fetchDcSweepResult());
+    drawSensitivity(uiState, result, circuitController.fetchSensitivityResult());
 
     if (!result.textualReport.empty() &&
         ImGui::CollapsingHeader("Raw Text Report")) {
@@ -159,19 +162,11 @@ void SimulationPanel::drawTransient(UiState& uiState, const TransientResult& tra
         }
     }
 
-    auto fetchSeries = [&](unsigned int nodeId) -> const std::vector<double>* {
-        auto it = transient.nodeIndex.find(nodeId);
-        if (it == transient.nodeIndex.end()) {
-            return nullptr;
-        }
-        const std::size_t index = it->second;
-        if (index >= transient.nodeVoltages.size()) {
-            return nullptr;
-        }
-        return &transient.nodeVoltages[index];
+    auto fetchSeries = [&](unsigned int nodeId) {
+        return transient.seriesForNode(nodeId);
     };
 
-    auto plotSeries = [&](const std::vector<double>& samples, std::vector<float>& buffer, const char* label) {
+    auto plotSeries = [&](const auto& samples, std::vector<float>& buffer, const char* label) {
         if (samples.empty()) {
             ImGui::TextUnformatted("No data to plot.");
             return;
@@ -202,7 +197,7 @@ void SimulationPanel::drawTransient(UiState& uiState, const TransientResult& tra
 
     if (transientState.selectedNodeIdx >= 0 &&
         transientState.selectedNodeIdx < static_cast<int>(transient.nodeIds.size())) {
-        const auto& series = transient.nodeVoltages[static_cast<std::size_t>(transientState.selectedNodeIdx)];
+        const auto series = transient.series(static_cast<std::size_t>(transientState.selectedNodeIdx));
         plotSeries(series, transientState.voltageBuffer, "Voltage (V)");
     }
 
@@ -263,8 +258,8 @@ void SimulationPanel::drawTransient(UiState& uiState, const TransientResult& tra
         return;
     }
 
-    const auto* vaSeries = fetchSeries(componentForCurrent->nodeA);
-    const auto* vbSeries = fetchSeries(componentForCurrent->nodeB);
+    const auto vaSeries = fetchSeries(componentForCurrent->nodeA);
+    const auto vbSeries = fetchSeries(componentForCurrent->nodeB);
     if (!vaSeries || !vbSeries || vaSeries->size() != vbSeries->size()) {
         ImGui::TextUnformatted("Missing voltage data for component nodes.");
         return;
@@ -323,3 +318,235 @@ void SimulationPanel::drawTransient(UiState& uiState, const TransientResult& tra
         plotSeries(currentSamples, transientState.currentBuffer, "Current (A)");
     }
 }
+
+void SimulationPanel::drawDcSweep(UiState& uiState, const DcSweepResult& sweep) {
+    auto& sweepState = uiState.dcSweep;
+
+    ImGui::Separator();
+    ImGui::TextUnformatted("DC Sweep");
+
+    std::vector<ComponentView> sweepable;
+    for (const auto& [id, component] : circuitController.getView().getComponents()) {
+        if (component.type == ComponentType::VSource ||
+            component.type == ComponentType::ISource ||
+            component.type == ComponentType::Resistor) {
+            sweepable.push_back(component);
+        }
+    }
+    std::sort(sweepable.begin(), sweepable.end(), [](const ComponentView& lhs, const ComponentView& rhs) {
+        return lhs.id < rhs.id;
+    });
+
+    if (sweepable.empty()) {
+        ImGui::TextUnformatted("Add a source or resistor to sweep its value.");
+        return;
+    }
+
+    if (!circuitController.getComponent(sweepState.sweptComponentId)) {
+        sweepState.sweptComponentId = sweepable.front().id;
+    }
+
+    const auto labels = circuitController.buildComponentLabels();
+    auto componentLabel = [&](const ComponentView& component) -> std::string {
+        if (auto it = labels.find(component.id); it != labels.end() && !it->second.empty()) {
+            return it->second;
+        }
+        return std::string(componentTypeName(component.type)) + " #" + std::to_string(component.id);
+    };
+
+    const auto swept = circuitController.getComponent(sweepState.sweptComponentId);
+    const std::string sweptLabel = swept ? componentLabel(*swept) : "Select component";
+    if (ImGui::BeginCombo("Swept component", sweptLabel.c_str())) {
+        for (const auto& component : sweepable) {
+            bool selected = component.id == sweepState.sweptComponentId;
+            if (ImGui::Selectable(componentLabel(component).c_str(), selected)) {
+                sweepState.sweptComponentId = component.id;
+            }
+            if (selected) {
+                ImGui::SetItemDefaultFocus();
+            }
+        }
+        ImGui::EndCombo();
+    }
+
+    ImGui::InputFloat("Start", &sweepState.start, 0.0f, 0.0f, "%.6f");
+    ImGui::InputFloat("Stop", &sweepState.stop, 0.0f, 0.0f, "%.6f");
+    ImGui::InputFloat("Increment", &sweepState.step, 0.0f, 0.0f, "%.6f");
+    const double sweepPoints = circuitx::DcSweep::linearPointCount(sweepState.start, sweepState.stop, sweepState.step);
+    const bool tooManyPoints = !(sweepPoints <= static_cast<double>(circuitx::DcSweep::maxPoints));
+    ImGui::BeginDisabled(!swept || sweepState.step == 0.0f || tooManyPoints);
+    if (ImGui::Button("Run DC sweep") && swept) {
+        circuitController.sweepDc(*swept, sweepState.start, sweepState.stop, sweepState.step);
+        sweepState.selectedNodeIdx = -1;
+    }
+    ImGui::EndDisabled();
+    if (tooManyPoints) {
+        ImGui::TextWrapped("This sweep would take %.3g points; the limit is %zu. Use a larger increment.",
+            sweepPoints, circuitx::DcSweep::maxPoints);
+    }
+
+    if (!sweep.solved || sweep.pointCount() == 0) {
+        ImGui::TextUnformatted("No sweep results available yet.");
+        return;
+    }
+
+    if (sweepState.selectedNodeIdx < 0 || sweepState.selectedNodeIdx >= static_cast<int>(sweep.nodeCount())) {
+        sweepState.selectedNodeIdx = 0;
+    }
+
+    auto nodeLabel = [&](unsigned int nodeId) -> std::string {
+        if (nodeId == sweep.referenceNodeId) {
+            return "GND";
+        }
+        return "Node " + std::to_string(nodeId);
+    };
+
+    const std::string currentLabel = nodeLabel(sweep.nodeIds[static_cast<std::size_t>(sweepState.selectedNodeIdx)]);
+    if (ImGui::BeginCombo("Sweep node", currentLabel.c_str())) {
+        for (std::size_t idx = 0; idx < sweep.nodeIds.size(); ++idx) {
+            bool selected = static_cast<int>(idx) == sweepState.selectedNodeIdx;
+            if (ImGui::Selectable(nodeLabel(sweep.nodeIds[idx]).c_str(), selected)) {
+                sweepState.selectedNodeIdx = static_cast<int>(idx);
+            }
+            if (selected) {
+                ImGui::SetItemDefaultFocus();
+            }
+        }
+        ImGui::EndCombo();
+    }
+
+    const auto series = sweep.series(static_cast<std::size_t>(sweepState.selectedNodeIdx));
+    auto& buffer = sweepState.voltageBuffer;
+    buffer.resize(series.size());
+    float minVal = std::numeric_limits<float>::max();
+    float maxVal = std::numeric_limits<float>::lowest();
+    for (std::size_t i = 0; i < series.size(); ++i) {
+        buffer[i] = static_cast<float>(series[i]);
+        minVal = std::min(minVal, buffer[i]);
+        maxVal = std::max(maxVal, buffer[i]);
+    }
+    if (minVal == maxVal) {
+        maxVal += 1.0f;
+        minVal -= 1.0f;
+    }
+    ImGui::PlotLines("Voltage vs. swept value",
+        buffer.data(),
+        static_cast<int>(buffer.size()),
+        0,
+        nullptr,
+        minVal,
+        maxVal,
+        ImVec2(-1, 160));
+    ImGui::Text("Points: %zu  |  %.6g .. %.6g",
+        sweep.pointCount(),
+        sweep.sweepValues.front(),
+        sweep.sweepValues.back());
+}
+
+void SimulationPanel::drawSensitivity(UiState& uiState, const SimulationResult& dc, const SensitivityResult& sensitivity) {
+    auto& sensitivityState = uiState.sensitivity;
+
+    ImGui::Separator();
+    ImGui::TextUnformatted("DC Sensitivity");
+
+    std::vector<const SimulationNodeResult*> outputs;
+    for (const auto& node : dc.nodes) {
+        if (node.id != dc.referenceNodeId) {
+            outputs.push_back(&node);
+        }
+    }
+    if (outputs.empty()) {
+        ImGui::TextUnformatted("Run a DC analysis to pick an output node.");
+        return;
+    }
+
+    const auto selected = std::find_if(outputs.begin(), outputs.end(), [&](const SimulationNodeResult* node) {
+        return sensitivityState.hasOutput && node->id == sensitivityState.outputNodeId;
+    });
+    if (selected == outputs.end()) {
+        sensitivityState.outputNodeId = outputs.front()->id;
+        sensitivityState.hasOutput = true;
+    }
+
+    auto nodeLabel = [](const SimulationNodeResult& node) -> std::string {
+        return node.name.empty() ? "Node " + std::to_string(node.id) : node.name;
+    };
+
+    const auto current = std::find_if(outputs.begin(), outputs.end(), [&](const SimulationNodeResult* node) {
+        return node->id == sensitivityState.outputNodeId;
+    });
+    if (ImGui::BeginCombo("Output node", nodeLabel(**current).c_str())) {
+        for (const auto* node : outputs) {
+            bool isSelected = node->id == sensitivityState.outputNodeId;
+            if (ImGui::Selectable(nodeLabel(*node).c_str(), isSelected)) {
+                sensitivityState.outputNodeId = node->id;
+            }
+            if (isSelected) {
+                ImGui::SetItemDefaultFocus();
+            }
+        }
+        ImGui::EndCombo();
+    }
+    if (ImGui::Button("Run sensitivity analysis")) {
+        circuitController.analyzeSensitivity(sensitivityState.outputNodeId);
+    }
+    if (ImGui::IsItemHovered(ImGuiHoveredFlags_DelayShort)) {
+        ImGui::SetTooltip("Derivatives of the output voltage with respect to every resistor and source value.");
+    }
+
+    if (!sensitivity.solved) {
+        ImGui::TextUnformatted("No sensitivity results available yet.");
+        return;
+    }
+
+    ImGui::Text("Node %u: %.6f V  |  ranked by effect of a 1%% change", sensitivity.outputNodeId, sensitivity.output);
+    if (sensitivity.elements.empty()) {
+        ImGui::TextUnformatted("No resistors or sources to rank.");
+        return;
+    }
+
+    // Element index -> editor label, via the component each element was created from.
+    const auto labels = circuitController.buildComponentLabels();
+    const CircuitService& service = circuitController.getService();
+    std::unordered_map<std::size_t, std::string> elementLabels;
+    for (const auto& [id, component] : circuitController.getView().getComponents()) {
+        if (auto index = service.findElementIndex(component.type, component.nodeA, component.nodeB)) {
+            auto it = labels.find(id);
+            elementLabels[*index] = it != labels.end() && !it->second.empty()
+                ? it->second
+                : std::string(componentTypeName(component.type)) + " #" + std::to_string(id);
+        }
+    }
+
+    if (ImGui::BeginTable("SensitivityRanking",
+            4,
+            ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY,
+            ImVec2(0.f, 200.f))) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Element");
+        ImGui::TableSetupColumn("Value");
+        ImGui::TableSetupColumn("dV/dValue");
+        ImGui::TableSetupColumn("ΔV per +1% (V)");
+        ImGui::TableHeadersRow();
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(sensitivity.elements.size()));
+        while (clipper.Step()) {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+                const auto& entry = sensitivity.elements[static_cast<std::size_t>(row)];
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex(0);
+                auto it = elementLabels.find(entry.elementIndex);
+                ImGui::TextUnformatted(it != elementLabels.end()
+                    ? it->second.c_str()
+                    : ("#" + std::to_string(entry.elementIndex)).c_str());
+                ImGui::TableSetColumnIndex(1);
+                ImGui::Text("%.6g", entry.value);
+                ImGui::TableSetColumnIndex(2);
+                ImGui::Text("%.6g", entry.derivative);
+                ImGui::TableSetColumnIndex(3);
+                ImGui::Text("%.6g", entry.normalized / 100.0);
+            }
+        }
+        ImGui::EndTable();
+    }
+}
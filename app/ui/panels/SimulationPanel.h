@@ -17,6 +17,8 @@ public:
 
 private:
     void drawTransient(UiState& uiState, const TransientResult& transient);
+    void drawDcSweep(UiState& uiState, const DcSweepResult& sweep);
+    void drawSensitivity(UiState& uiState, const SimulationResult& dc, const SensitivityResult& sensitivity);
 
     CircuitController& circuitController;
 };
@@ -0,0 +1,214 @@
+// Lane-batched vs thread-parallel ensemble transients on an RC mesh.
+//
+//   circuitx_benchmarks [mesh side = 20] [members = 64] [repetitions = 3]
+//
+// Part 1 times the numeric kernels alone: one scalar CircuitLu refactor/solve against one BatchedCircuitLu
+// factor/solve that carries 4 or 8 variants. Part 2 times Circuit::simulateEnsemble with lanes and/or
+// threads and checks every configuration against the single-threaded scalar run.
+
+#include <circuitx/circuit.hpp>
+
+#include "solving/BatchedCircuitLu.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace circuitx;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double microseconds(Clock::time_point begin, Clock::time_point end, int repetitions) {
+        return std::chrono::duration<double, std::micro>(end - begin).count() / repetitions;
+    }
+
+    // Nodal matrix of a side x side resistor mesh with a capacitor companion conductance on every node.
+    Eigen::SparseMatrix<double> meshMatrix(int side) {
+        std::vector<Eigen::Triplet<double>> triplets;
+        auto index = [side](int row, int column) { return row * side + column; };
+        auto link = [&](int a, int b) {
+            triplets.emplace_back(a, a, 0.01);
+            triplets.emplace_back(b, b, 0.01);
+            triplets.emplace_back(a, b, -0.01);
+            triplets.emplace_back(b, a, -0.01);
+        };
+        for (int row = 0; row < side; ++row) {
+            for (int column = 0; column < side; ++column) {
+                triplets.emplace_back(index(row, column), index(row, column), 0.1);
+                if (column + 1 < side) {
+                    link(index(row, column), index(row, column + 1));
+                }
+                if (row + 1 < side) {
+                    link(index(row, column), index(row + 1, column));
+                }
+            }
+        }
+        Eigen::SparseMatrix<double> matrix(side * side, side * side);
+        matrix.setFromTriplets(triplets.begin(), triplets.end());
+        matrix.makeCompressed();
+        return matrix;
+    }
+
+    template <int Width>
+    void benchmarkKernel(const Eigen::SparseMatrix<double>& matrix, int repetitions) {
+        CircuitLu scalar;
+        scalar.analyze(matrix);
+        scalar.factorize(matrix);
+        scalar.refactorize(matrix);
+        const Eigen::VectorXd rhs = Eigen::VectorXd::Ones(matrix.rows());
+        double checksum = 0.0;
+
+        const auto scalarBegin = Clock::now();
+        for (int r = 0; r < repetitions; ++r) {
+            scalar.refactorize(matrix);
+        }
+        const auto scalarFactored = Clock::now();
+        for (int r = 0; r < repetitions; ++r) {
+            checksum += scalar.solve(rhs)(0);
+        }
+        const auto scalarSolved = Clock::now();
+
+        BatchedCircuitLu<Width> batched;
+        batched.analyze(matrix);
+        std::vector<Lanes<Width>> values(static_cast<std::size_t>(matrix.nonZeros()));
+        std::vector<Lanes<Width>> laneRhs(static_cast<std::size_t>(matrix.rows()));
+        std::vector<Lanes<Width>> solution(laneRhs.size());
+        for (std::size_t p = 0; p < values.size(); ++p) {
+            for (int lane = 0; lane < Width; ++lane) {
+                values[p].v[lane] = matrix.valuePtr()[p] * (1.0 + 0.01 * lane);
+            }
+        }
+        for (Lanes<Width>& lanes : laneRhs) {
+            std::fill(std::begin(lanes.v), std::end(lanes.v), 1.0);
+        }
+        batched.factorize(values.data());
+
+        const auto batchedBegin = Clock::now();
+        for (int r = 0; r < repetitions; ++r) {
+            batched.factorize(values.data());
+        }
+        const auto batchedFactored = Clock::now();
+        for (int r = 0; r < repetitions; ++r) {
+            batched.solve(laneRhs.data(), solution.data());
+            checksum += solution[0].v[0];
+        }
+        const auto batchedSolved = Clock::now();
+
+        const double batchedFactor = microseconds(batchedBegin, batchedFactored, repetitions);
+        const double batchedSolve = microseconds(batchedFactored, batchedSolved, repetitions);
+        std::printf("  %d lanes, n = %ld: scalar factor %8.1f us, solve %7.1f us | %d-lane factor %8.1f us (%.2fx scalar), "
+                    "solve %7.1f us (%.2fx scalar)   [checksum %.3g]\n",
+            Width, static_cast<long>(matrix.rows()), microseconds(scalarBegin, scalarFactored, repetitions),
+            microseconds(scalarFactored, scalarSolved, repetitions), Width, batchedFactor,
+            batchedFactor / microseconds(scalarBegin, scalarFactored, repetitions), batchedSolve,
+            batchedSolve / microseconds(scalarFactored, scalarSolved, repetitions), checksum);
+    }
+
+    // side x side RC mesh fed from a 5 V source through 10 ohm; members spread every R and C by 5 %.
+    Circuit meshCircuit(int side, int members, EnsembleOptions& options) {
+        Circuit circuit;
+        auto id = [side](int row, int column) { return static_cast<unsigned int>(1 + row * side + column); };
+        const auto source = static_cast<unsigned int>(side * side + 1);
+        for (unsigned int node = 0; node <= source; ++node) {
+            circuit.addNode({node, "n" + std::to_string(node)});
+        }
+
+        std::size_t elements = 0;
+        std::vector<std::size_t> resistors;
+        std::vector<std::size_t> capacitors;
+        auto add = [&](const Element& element) { circuit.addElement(element); return elements++; };
+        add(VSource{source, 0, 5.0f});
+        add(Res{source, id(0, 0), 10.0f});
+        for (int row = 0; row < side; ++row) {
+            for (int column = 0; column < side; ++column) {
+                if (column + 1 < side) {
+                    resistors.push_back(add(Res{id(row, column), id(row, column + 1), 100.0f}));
+                }
+                if (row + 1 < side) {
+                    resistors.push_back(add(Res{id(row, column), id(row + 1, column), 100.0f}));
+                }
+                capacitors.push_back(add(Cap{id(row, column), 0, 1e-6f}));
+            }
+        }
+
+        SolverOptions solverOptions;
+        solverOptions.backend = MatrixBackend::Sparse;
+        circuit.setSolverOptions(solverOptions);
+
+        std::mt19937 rng(1);
+        std::normal_distribution<double> tolerance(1.0, 0.05);
+        options.transient.durationSeconds = 2e-3;
+        options.transient.timestepSeconds = 1e-5;
+        for (int m = 0; m < members; ++m) {
+            std::vector<ValueChange> changes;
+            for (const std::size_t element : resistors) {
+                changes.push_back({element, 100.0 * tolerance(rng)});
+            }
+            for (const std::size_t element : capacitors) {
+                changes.push_back({element, 1e-6 * tolerance(rng)});
+            }
+            options.members.push_back(std::move(changes));
+        }
+        return circuit;
+    }
+
+    void benchmarkEnsemble(int side, int members, int repetitions) {
+        EnsembleOptions options;
+        Circuit circuit = meshCircuit(side, members, options);
+        const unsigned hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+
+        // Single-threaded scalar first: it is the reference for the timings and the waveforms.
+        std::vector<std::pair<unsigned, unsigned>> configurations{{1, 0}, {1, 4}, {1, 8}};
+        if (hardwareThreads > 1) {
+            configurations.insert(configurations.end(), {{hardwareThreads, 0}, {hardwareThreads, 4}, {hardwareThreads, 8}});
+        }
+
+        EnsembleResult reference;
+        double scalarMilliseconds = 0.0;
+        for (const auto& [threads, lanes] : configurations) {
+            options.threads = threads;
+            options.simdLanes = lanes;
+            EnsembleResult result = circuit.simulateEnsemble(options); // warm-up
+            double best = INFINITY;
+            for (int r = 0; r < repetitions; ++r) {
+                const auto begin = Clock::now();
+                result = circuit.simulateEnsemble(options);
+                best = std::min(best, std::chrono::duration<double, std::milli>(Clock::now() - begin).count());
+            }
+            if (reference.waveforms.empty()) {
+                reference = result;
+                scalarMilliseconds = best;
+            }
+            double difference = 0.0;
+            for (std::size_t i = 0; i < result.waveforms.size(); ++i) {
+                difference = std::max(difference, std::abs(result.waveforms[i] - reference.waveforms[i]));
+            }
+            std::printf("  threads %2u, lanes %u: %8.1f ms (%.2fx single-threaded scalar), %zu/%d members in lanes, "
+                        "max |diff| %.2g\n",
+                threads, lanes, best, scalarMilliseconds / best, result.laneBatchedMembers, members, difference);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    const int side = argc > 1 ? std::max(2, std::atoi(argv[1])) : 20;
+    const int members = argc > 2 ? std::max(1, std::atoi(argv[2])) : 64;
+    const int repetitions = argc > 3 ? std::max(1, std::atoi(argv[3])) : 3;
+
+    std::printf("Kernels (%dx%d mesh):\n", side, side);
+    const Eigen::SparseMatrix<double> matrix = meshMatrix(side);
+    benchmarkKernel<4>(matrix, 200);
+    benchmarkKernel<8>(matrix, 200);
+
+    std::printf("Ensemble transient (%dx%d RC mesh, %d members, %u hardware threads):\n", side, side, members,
+        std::max(1u, std::thread::hardware_concurrency()));
+    benchmarkEnsemble(side, members, repetitions);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,56 @@
+#ifndef CIRCUITX_AC_HPP
+#define CIRCUITX_AC_HPP
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace circuitx {
+    struct AcOptions {
+        // Largest grid analyzeAc() accepts; every point keeps a magnitude and phase per node.
+        static constexpr std::size_t maxPoints = 100000;
+
+        double startHz = 1.0;
+        double stopHz = 1e6;
+        bool logarithmic = true;
+        std::size_t pointsPerDecade = 20; // logarithmic grid
+        std::size_t points = 100;         // linear grid
+        // Source driven with unit amplitude, all others zeroed. Without it every source is driven
+        // with its DC value as amplitude (phase 0).
+        std::optional<std::size_t> sourceElement;
+        unsigned threads = 0;             // 0 = one per hardware thread
+    };
+
+    struct AcResult {
+        bool solved = false;
+        unsigned int referenceNodeId = 0;
+        std::vector<double> frequencies; // Hz
+        std::vector<unsigned int> nodeIds; // ground is the last column
+        // Node-major: node column c occupies [c * frequencies.size(), (c + 1) * frequencies.size()).
+        std::vector<double> magnitude;
+        std::vector<double> phaseDegrees;
+        std::unordered_map<unsigned int, std::size_t> nodeIndex; // includes wire-merged aliases
+
+        [[nodiscard]] std::size_t pointCount() const { return frequencies.size(); }
+        [[nodiscard]] std::size_t nodeCount() const { return nodeIds.size(); }
+
+        [[nodiscard]] std::span<const double> magnitudeSeries(std::size_t column) const {
+            return column < nodeCount() ? std::span<const double>(magnitude).subspan(column * pointCount(), pointCount())
+                                        : std::span<const double>();
+        }
+
+        [[nodiscard]] std::span<const double> phaseSeries(std::size_t column) const {
+            return column < nodeCount() ? std::span<const double>(phaseDegrees).subspan(column * pointCount(), pointCount())
+                                        : std::span<const double>();
+        }
+
+        [[nodiscard]] std::optional<std::size_t> columnForNode(unsigned int nodeId) const {
+            auto it = nodeIndex.find(nodeId);
+            return it == nodeIndex.end() ? std::nullopt : std::optional<std::size_t>(it->second);
+        }
+    };
+}
+
+#endif //CIRCUITX_AC_HPP
@@ -9,9 +9,21 @@
 #include <string>
 #include <variant>
 #include <vector>
+#include <functional>
+#include <memory>
+#include <span>
 #include <Eigen/Core>
 #include <unordered_map>
 
+#include "ac.hpp"
+#include "ensemble.hpp"
+#include "faults.hpp"
+#include "montecarlo.hpp"
+#include "sensitivity.hpp"
+#include "sweep.hpp"
+#include "transient.hpp"
+#include "whatif.hpp"
+
 namespace circuitx {
     struct Node {
         unsigned int id;
@@ -28,38 +40,149 @@ namespace circuitx {
 
     typedef std::variant<Res, Cap, VSource, ISource, Wire> Element;
 
-    struct TransientResult {
-        bool solved = false;
-        double timestep = 0.0;
-        unsigned int referenceNodeId = 0;
-        std::vector<double> times;
-        std::vector<unsigned int> nodeIds;
-        std::vector<std::vector<double>> nodeVoltages;
-        std::unordered_map<unsigned int, std::size_t> nodeIndex;
+    enum class MatrixBackend {
+        Automatic, // dense below SolverOptions::sparseThreshold unknowns, sparse from there on
+        Dense,
+        Sparse,
+        Iterative  // preconditioned CG (SolverOptions::iterative) for SPD DC systems; anything else solves as Sparse
+    };
+
+    enum class SparseFactorization {
+        CircuitLu, // block triangular form + AMD per block + threshold-pivoted LU that refactors with the same pivots
+        GeneralLu  // Eigen's supernodal SparseLU with COLAMD
+    };
+
+    // Fill-reducing ordering of every diagonal block CircuitLu factors.
+    enum class FillOrdering {
+        Automatic, // chosen per block from its graph: COLAMD if strongly unsymmetric, nested dissection for large meshes, else AMD
+        Natural,
+        Amd,
+        Colamd,
+        NestedDissection
+    };
+
+    enum class PreconditionerType {
+        Jacobi,
+        IncompleteCholesky, // zero fill-in IC in node order
+        AlgebraicMultigrid  // smoothed aggregation; its hierarchy is kept while the topology is unchanged
+    };
+
+    struct IterativeOptions {
+        PreconditionerType preconditioner = PreconditionerType::IncompleteCholesky;
+        double tolerance = 1e-10; // relative residual ||b - Ax|| / ||b||
+        int maxIterations = 1000;
+        bool warmStart = true;    // start from the previous solution of the same system (sweeps, edits)
+
+        bool operator==(const IterativeOptions&) const = default;
     };
 
+    struct SolverOptions {
+        MatrixBackend backend = MatrixBackend::Automatic;
+        int sparseThreshold = 128;
+        SparseFactorization factorization = SparseFactorization::CircuitLu;
+        FillOrdering ordering = FillOrdering::Automatic; // GeneralLu always uses COLAMD
+        // Circuits of positive R, C and current sources only are symmetric positive definite: factor them with
+        // LDL^T (dense: LL^T) instead of LU/QR, for DC and transient solves.
+        bool useCholesky = true;
+        // Solve subcircuits that only share ground as independent blocks.
+        bool decomposeBlocks = true;
+        // Blocks are factored on worker threads from this many unknowns on; threads = 0 uses all cores.
+        int parallelBlockThreshold = 256;
+        unsigned threads = 0;
+        IterativeOptions iterative;
+
+        bool operator==(const SolverOptions&) const = default;
+    };
+
+    struct SolverStatistics {
+        bool sparse = false;
+        bool reusedTopology = false;  // unify/MNA context came from the topology cache
+        bool reusedSymbolic = false;  // only the numeric factorization was redone
+        std::size_t systemSize = 0;
+        std::size_t blocks = 1;       // independent diagonal blocks the system was split into
+        bool symmetric = false;       // factored with Cholesky (LDL^T / LL^T) rather than LU/QR
+        // Sparse solves only: the ordering used (for the largest block) and the resulting fill-in.
+        FillOrdering ordering = FillOrdering::Natural;
+        std::size_t matrixNonZeros = 0; // nnz(A)
+        std::size_t factorNonZeros = 0; // nnz(L + U)
+        // Iterative backend only: CG iterations summed over the right-hand sides and the worst relative residual.
+        bool iterative = false;
+        std::size_t iterations = 0;
+        double residual = 0.0;
+        bool converged = true;
+
+        [[nodiscard]] double fillRatio() const {
+            return matrixNonZeros == 0 ? 0.0 : static_cast<double>(factorNonZeros) / static_cast<double>(matrixNonZeros);
+        }
+    };
+
+    struct SolverCache;
+
     class Circuit {
     public:
-        Circuit() {}
+        Circuit();
         virtual ~Circuit() {}
 
-        void addNode(const Node& n) { nodes.push_back(n); }
-        void addElement(const Element& e) { elements.push_back(e); }
+        void addNode(const Node& n);
+        void addElement(const Element& e);
+        std::size_t removeElementsIf(const std::function<bool(const Element&)>& predicate);
+        void removeNode(unsigned int nodeId);
+        // Changes the value (R, C, V or I) of one element; topology and the supernode map stay intact.
+        bool setElementValue(std::size_t index, float value);
 
         Eigen::VectorXd solve();
+        // Solves the DC operating point for every value in sweep.values. Source sweeps share one
+        // factorization (block right-hand side); other parameters refactor with the same symbolic analysis.
+        DcSweepResult sweepDc(const DcSweep& sweep);
+        // DC operating-point statistics with every resistor drawn within options.resistorTolerance.
+        MonteCarloResult runMonteCarlo(const MonteCarloOptions& options);
+        // DC solution with `changes` applied on top of the current values; the circuit itself is left untouched.
+        // Builds on the factorization of the last solve() (solving first if values, topology or options changed
+        // since): up to options.maxRank changed resistors enter as a Woodbury low-rank update, more refactor a copy.
+        WhatIfResult solveWhatIf(std::span<const ValueChange> changes, const WhatIfOptions& options = {});
+        // Opens and shorts every resistor and capacitor in turn (one fault at a time) and reports the DC voltage
+        // change at the observed nodes. All faults are rank-1 updates of one factorization, spread over threads.
+        FaultResult simulateFaults(const FaultOptions& options = {});
+        // DC sensitivities of V(output) - V(reference) to every resistor and source value: one transposed solve
+        // with the DC factorization (reusing the last solve()'s when values and options are unchanged).
+        SensitivityResult analyzeSensitivity(const SensitivityOptions& options);
+        // Small-signal frequency response (G + jwC) over the options' frequency grid; unsolved if the grid is empty
+        // or longer than AcOptions::maxPoints.
+        AcResult analyzeAc(const AcOptions& options);
         TransientResult simulateTransient(double durationSeconds, double timestepSeconds);
+        // Streams samples to the sink instead of keeping them; returns false if nothing was simulated.
+        bool simulateTransient(double durationSeconds, double timestepSeconds, TransientSink& sink);
+        TransientResult simulateTransient(const TransientOptions& options);
+        bool simulateTransient(const TransientOptions& options, TransientSink& sink);
+        // Runs options.transient once per parameter set, concurrently. The members share the topology analysis
+        // and the output grid; each worker reuses its symbolic factorization across its members.
+        EnsembleResult simulateEnsemble(const EnsembleOptions& options);
+
+        void setSolverOptions(const SolverOptions& options) { solverOptions = options; }
+        [[nodiscard]] const SolverOptions& getSolverOptions() const { return solverOptions; }
+        [[nodiscard]] const SolverStatistics& lastSolveStatistics() const { return statistics; }
+        [[nodiscard]] const TransientStatistics& lastTransientStatistics() const { return transientStatistics; }
 
         [[nodiscard]] std::vector<Element> getElements() const { return elements; }
         [[nodiscard]] std::vector<Node> getNodes() const { return nodes; }
-        std::vector<Element>& elementsMutable() { return elements; }
-        std::vector<Node>& nodesMutable() { return nodes; }
+        [[nodiscard]] const std::vector<Element>& elementsView() const { return elements; }
+        // Raw access may rewire anything, so it invalidates the supernode map.
+        std::vector<Element>& elementsMutable() { supernodesDirty = true; return elements; }
+        std::vector<Node>& nodesMutable() { supernodesDirty = true; return nodes; }
         [[nodiscard]] nlohmann::json toJson() const;
         [[nodiscard]] const std::vector<unsigned int>& solutionNodeOrdering() const { return nodeOrdering; }
         [[nodiscard]] const std::vector<std::size_t>& solutionVoltageOrdering() const { return voltageOrdering; }
         [[nodiscard]] unsigned int solutionGround() const { return solutionGroundId; }
+        // Representative node of the wire-merged supernode containing nodeId.
+        [[nodiscard]] unsigned int supernodeOf(unsigned int nodeId);
 
     private:
+        // solve() without unify/locking; the caller holds solverCache->mutex.
+        Eigen::VectorXd solveLocked();
         void unify();
+        void uniteNodes(unsigned int a, unsigned int b);
+        [[nodiscard]] std::size_t findSupernode(std::size_t slot);
+        [[nodiscard]] std::function<unsigned int(unsigned int)> supernodeResolver();
 
         Eigen::VectorXd getVector();
         Eigen::MatrixXd getMatrix();
@@ -68,11 +191,21 @@ namespace circuitx {
             unsigned int groundId);
     private:
         std::vector<Node> united;
+        std::unordered_map<unsigned int, std::size_t> nodeSlots;
+        std::vector<std::size_t> supernodeParent;
+        bool supernodesDirty = true; // union-find must be rebuilt from scratch
+        bool unitedDirty = true;     // only the representative list is stale
         std::vector<Node> nodes;
         std::vector<Element> elements;
         std::vector<unsigned int> nodeOrdering;
         std::vector<std::size_t> voltageOrdering;
         unsigned int solutionGroundId = 0;
+        SolverOptions solverOptions;
+        SolverStatistics statistics;
+        TransientStatistics transientStatistics;
+        // Shared between copies: it is keyed by the topology hash, so a copy with edited values
+        // still benefits from the symbolic analysis of the original.
+        std::shared_ptr<SolverCache> solverCache;
     };
 }
 
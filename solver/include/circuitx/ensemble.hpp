@@ -0,0 +1,75 @@
+#ifndef CIRCUITX_ENSEMBLE_HPP
+#define CIRCUITX_ENSEMBLE_HPP
+
+#include "transient.hpp"
+#include "whatif.hpp"
+
+#include <cstddef>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace circuitx {
+    enum class EnsembleOutput {
+        Waveforms, // every member's waveform at the observed nodes
+        Statistics // mean / stddev / min / max over the members per node and sample; no per-member storage
+    };
+
+    struct EnsembleOptions {
+        TransientOptions transient;
+        // One parameter set per member, applied on top of the circuit's own values (later changes of an element win).
+        std::vector<std::vector<ValueChange>> members;
+        EnsembleOutput output = EnsembleOutput::Waveforms;
+        std::vector<unsigned int> observedNodes; // empty observes every node
+        unsigned threads = 0;                    // 0 = one per hardware thread
+        // 4 or 8 (other values round down, 0 = off): fixed-step runs on sparse CircuitLu systems solve this
+        // many members together as SIMD lanes of one batched factorization. Results agree with the
+        // member-by-member runs to rounding; members that need their own pivoting fall back to them.
+        // 8 lanes pay off with AVX2 / AVX-512 code (CIRCUITX_NATIVE_ARCH); a baseline x86-64 build favours 4.
+        unsigned simdLanes = 0;
+    };
+
+    // Transient runs of one topology with different values, all on the shared output grid `times`.
+    struct EnsembleResult {
+        bool solved = false;
+        double timestep = 0.0;
+        unsigned int referenceNodeId = 0;
+        std::vector<double> times;
+        std::vector<unsigned int> nodeIds; // observed nodes; without observedNodes ground is the last column
+        std::unordered_map<unsigned int, std::size_t> nodeIndex; // includes wire-merged aliases
+        std::vector<bool> memberSolved;    // false for members whose DC point or transient had no finite solution
+        std::size_t failedMembers = 0;
+        std::size_t laneBatchedMembers = 0; // members solved in SIMD lane groups (see simdLanes)
+        // Waveforms: member-major, then node-major, so every (member, column) waveform is contiguous.
+        std::vector<double> waveforms;
+        // Statistics over the solved members, node-major: column c occupies [c * sampleCount(), (c + 1) * sampleCount()).
+        std::vector<double> mean;
+        std::vector<double> stddev;
+        std::vector<double> min;
+        std::vector<double> max;
+
+        [[nodiscard]] std::size_t memberCount() const { return memberSolved.size(); }
+        [[nodiscard]] std::size_t sampleCount() const { return times.size(); }
+        [[nodiscard]] std::size_t nodeCount() const { return nodeIds.size(); }
+
+        [[nodiscard]] std::span<const double> waveform(std::size_t member, std::size_t column) const {
+            return member < memberCount() && column < nodeCount() && !waveforms.empty()
+                ? std::span<const double>(waveforms).subspan((member * nodeCount() + column) * sampleCount(), sampleCount())
+                : std::span<const double>();
+        }
+
+        [[nodiscard]] std::span<const double> meanSeries(std::size_t column) const { return statisticSeries(mean, column); }
+        [[nodiscard]] std::span<const double> stddevSeries(std::size_t column) const { return statisticSeries(stddev, column); }
+        [[nodiscard]] std::span<const double> minSeries(std::size_t column) const { return statisticSeries(min, column); }
+        [[nodiscard]] std::span<const double> maxSeries(std::size_t column) const { return statisticSeries(max, column); }
+
+    private:
+        [[nodiscard]] std::span<const double> statisticSeries(const std::vector<double>& values, std::size_t column) const {
+            return column < nodeCount() && !values.empty()
+                ? std::span<const double>(values).subspan(column * sampleCount(), sampleCount())
+                : std::span<const double>();
+        }
+    };
+}
+
+#endif //CIRCUITX_ENSEMBLE_HPP
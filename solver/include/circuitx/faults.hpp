@@ -0,0 +1,60 @@
+#ifndef CIRCUITX_FAULTS_HPP
+#define CIRCUITX_FAULTS_HPP
+
+#include <cstddef>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace circuitx {
+    enum class FaultKind {
+        Open,
+        Short
+    };
+
+    struct FaultOptions {
+        // Faulted elements are replaced by these resistances; a finite open keeps floating nodes solvable.
+        double openResistance = 1e9;
+        double shortResistance = 1e-3;
+        double detectionThreshold = 1e-3;        // volts at any observed node
+        std::vector<unsigned int> observedNodes; // test points; empty observes every node
+        bool keepDeltas = true;                  // store the faults x observed nodes delta table
+        unsigned threads = 0;                    // 0 = one per hardware thread
+    };
+
+    // One single-fault DC solve: the voltage change it causes at the observed nodes.
+    struct FaultReport {
+        std::size_t elementIndex = 0;
+        FaultKind kind = FaultKind::Open;
+        bool solved = false;
+        double maxDelta = 0.0;       // largest |dV| over the observed nodes
+        unsigned int worstNodeId = 0;
+        bool detected = false;       // maxDelta >= detectionThreshold
+    };
+
+    // Every resistor and capacitor opened and shorted in turn (open, then short, in element order).
+    struct FaultResult {
+        bool solved = false;
+        unsigned int referenceNodeId = 0;
+        std::vector<unsigned int> nodeIds; // observed nodes; without observedNodes ground is the last column
+        std::unordered_map<unsigned int, std::size_t> nodeIndex; // includes wire-merged aliases
+        std::vector<FaultReport> faults;
+        // Fault-major: deltas of fault f occupy [f * nodeCount(), (f + 1) * nodeCount()).
+        std::vector<double> deltas;
+        std::size_t detectedFaults = 0;
+
+        [[nodiscard]] std::size_t nodeCount() const { return nodeIds.size(); }
+
+        [[nodiscard]] std::span<const double> deltasForFault(std::size_t fault) const {
+            return fault < faults.size() && !deltas.empty()
+                ? std::span<const double>(deltas).subspan(fault * nodeCount(), nodeCount())
+                : std::span<const double>();
+        }
+
+        [[nodiscard]] double coverage() const {
+            return faults.empty() ? 0.0 : static_cast<double>(detectedFaults) / static_cast<double>(faults.size());
+        }
+    };
+}
+
+#endif //CIRCUITX_FAULTS_HPP
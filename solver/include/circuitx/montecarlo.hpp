@@ -0,0 +1,51 @@
+#ifndef CIRCUITX_MONTECARLO_HPP
+#define CIRCUITX_MONTECARLO_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace circuitx {
+    enum class ToleranceDistribution {
+        Uniform,  // value * (1 + u), u uniform in [-tolerance, tolerance]
+        Gaussian  // value * (1 + n), n normal with sigma = tolerance / 3
+    };
+
+    struct MonteCarloOptions {
+        std::size_t trials = 1000;
+        double resistorTolerance = 0.05; // capacitors are open at DC, so only resistors are perturbed
+        ToleranceDistribution distribution = ToleranceDistribution::Uniform;
+        std::uint64_t seed = 1;      // trial i always draws from the stream derived from (seed, i)
+        unsigned threads = 0;        // 0 = one per hardware thread
+        std::size_t histogramBins = 32;
+    };
+
+    struct NodeStatistics {
+        double mean = 0.0;
+        double stddev = 0.0;
+        double min = 0.0;
+        double max = 0.0;
+        // Equal-width bins over [histogramMin, histogramMax]; values outside land in the edge bins.
+        double histogramMin = 0.0;
+        double histogramMax = 0.0;
+        std::vector<std::size_t> histogram;
+    };
+
+    // DC operating-point statistics over all successful trials; nothing per trial is stored.
+    struct MonteCarloResult {
+        bool solved = false;
+        std::size_t trials = 0;
+        std::size_t failedTrials = 0; // singular or non-finite solutions, excluded from the statistics
+        unsigned int referenceNodeId = 0;
+        std::vector<unsigned int> nodeIds; // ground is the last column
+        std::unordered_map<unsigned int, std::size_t> nodeIndex;
+        std::vector<NodeStatistics> nodes; // indexed like nodeIds
+
+        [[nodiscard]] const NodeStatistics* statisticsForNode(unsigned int nodeId) const {
+            auto it = nodeIndex.find(nodeId);
+            return it == nodeIndex.end() ? nullptr : &nodes[it->second];
+        }
+    };
+}
+
+#endif //CIRCUITX_MONTECARLO_HPP
@@ -0,0 +1,32 @@
+#ifndef CIRCUITX_SENSITIVITY_HPP
+#define CIRCUITX_SENSITIVITY_HPP
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace circuitx {
+    // Output: V(outputNodeId) - V(referenceNodeId) at the DC operating point.
+    struct SensitivityOptions {
+        unsigned int outputNodeId = 0;
+        std::optional<unsigned int> referenceNodeId; // defaults to the solution's ground
+    };
+
+    struct ElementSensitivity {
+        std::size_t elementIndex = 0;
+        double value = 0.0;       // R, V or I as stamped
+        double derivative = 0.0;  // d output / d value: V/Ohm for resistors, V/V for voltage sources, V/A for current sources
+        double normalized = 0.0;  // value * derivative: output change (V) per 100 % change of the value
+    };
+
+    // d output / d value for every resistor (positive R) and every source, from one adjoint solve.
+    struct SensitivityResult {
+        bool solved = false;
+        unsigned int outputNodeId = 0;
+        unsigned int referenceNodeId = 0;
+        double output = 0.0;
+        std::vector<ElementSensitivity> elements; // ranked by |normalized|, largest first
+    };
+}
+
+#endif //CIRCUITX_SENSITIVITY_HPP
@@ -0,0 +1,74 @@
+#ifndef CIRCUITX_SWEEP_HPP
+#define CIRCUITX_SWEEP_HPP
+
+#include <cmath>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace circuitx {
+    // Values to assign to one element (index into Circuit::elementsView()) during a DC sweep.
+    struct DcSweep {
+        std::size_t elementIndex = 0;
+        std::vector<double> values;
+
+        // Largest sweep linear() builds; every point keeps one voltage per node.
+        static constexpr std::size_t maxPoints = 100000;
+
+        // Points linear() would produce, before the maxPoints cap (NaN for non-finite bounds).
+        static double linearPointCount(double start, double stop, double step) {
+            if (step == 0.0 || (stop - start) / step < 0.0) {
+                return 1.0;
+            }
+            return std::floor((stop - start) / step + 1e-9) + 1.0;
+        }
+
+        // start, start + step, ... up to and including stop (within rounding). Empty if that is more than
+        // maxPoints points or the bounds are not finite.
+        static DcSweep linear(std::size_t elementIndex, double start, double stop, double step) {
+            DcSweep sweep{elementIndex, {}};
+            const double points = linearPointCount(start, stop, step);
+            if (!(points <= static_cast<double>(maxPoints))) {
+                return sweep;
+            }
+            const auto count = static_cast<std::size_t>(points);
+            sweep.values.reserve(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                sweep.values.push_back(start + static_cast<double>(i) * step);
+            }
+            return sweep;
+        }
+    };
+
+    struct DcSweepResult {
+        bool solved = false;
+        std::size_t elementIndex = 0;
+        unsigned int referenceNodeId = 0;
+        std::vector<double> sweepValues;
+        std::vector<unsigned int> nodeIds; // ground is the last column
+        // Node-major: node column c occupies [c * sweepValues.size(), (c + 1) * sweepValues.size()).
+        std::vector<double> voltages;
+        std::unordered_map<unsigned int, std::size_t> nodeIndex; // includes wire-merged aliases
+
+        [[nodiscard]] std::size_t pointCount() const { return sweepValues.size(); }
+        [[nodiscard]] std::size_t nodeCount() const { return nodeIds.size(); }
+
+        [[nodiscard]] std::span<const double> series(std::size_t column) const {
+            if (column >= nodeCount()) {
+                return {};
+            }
+            return std::span<const double>(voltages).subspan(column * pointCount(), pointCount());
+        }
+
+        [[nodiscard]] std::optional<std::span<const double>> seriesForNode(unsigned int nodeId) const {
+            auto it = nodeIndex.find(nodeId);
+            if (it == nodeIndex.end()) {
+                return std::nullopt;
+            }
+            return series(it->second);
+        }
+    };
+}
+
+#endif //CIRCUITX_SWEEP_HPP
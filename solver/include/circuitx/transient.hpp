@@ -0,0 +1,190 @@
+#ifndef CIRCUITX_TRANSIENT_HPP
+#define CIRCUITX_TRANSIENT_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace circuitx {
+    // Strided, non-owning view of one node's waveform inside TransientResult::samples.
+    class NodeSeries {
+    public:
+        NodeSeries() = default;
+        NodeSeries(const double* first, std::size_t stride, std::size_t count)
+            : first(first), stride(stride), count(count) {}
+
+        [[nodiscard]] std::size_t size() const { return count; }
+        [[nodiscard]] bool empty() const { return count == 0; }
+        double operator[](std::size_t i) const { return first[i * stride]; }
+
+    private:
+        const double* first = nullptr;
+        std::size_t stride = 0;
+        std::size_t count = 0;
+    };
+
+    struct TransientResult {
+        bool solved = false;
+        double timestep = 0.0;
+        unsigned int referenceNodeId = 0;
+        std::vector<double> times;
+        std::vector<unsigned int> nodeIds;
+        // Time-major: sample i occupies [i * nodeIds.size(), (i + 1) * nodeIds.size()).
+        std::vector<double> samples;
+        std::unordered_map<unsigned int, std::size_t> nodeIndex;
+
+        [[nodiscard]] std::size_t sampleCount() const { return times.size(); }
+        [[nodiscard]] std::size_t nodeCount() const { return nodeIds.size(); }
+
+        [[nodiscard]] std::span<const double> sampleAt(std::size_t sample) const {
+            return std::span<const double>(samples).subspan(sample * nodeCount(), nodeCount());
+        }
+
+        [[nodiscard]] NodeSeries series(std::size_t column) const {
+            if (column >= nodeCount()) {
+                return {};
+            }
+            return NodeSeries(samples.data() + column, nodeCount(), sampleCount());
+        }
+
+        [[nodiscard]] std::optional<NodeSeries> seriesForNode(unsigned int nodeId) const {
+            auto it = nodeIndex.find(nodeId);
+            if (it == nodeIndex.end()) {
+                return std::nullopt;
+            }
+            return series(it->second);
+        }
+    };
+
+    // Column layout shared by every sample of one transient run (ground is the last column).
+    struct TransientLayout {
+        double timestep = 0.0;
+        unsigned int referenceNodeId = 0;
+        std::vector<unsigned int> nodeIds;
+        std::unordered_map<unsigned int, std::size_t> nodeIndex; // includes wire-merged aliases
+        std::size_t expectedSamples = 0;                         // hint, including the t = 0 sample
+    };
+
+    enum class IntegrationMethod {
+        BackwardEuler, // first order, L-stable
+        Trapezoidal,   // second order, A-stable, may ring on very stiff steps
+        Gear2          // BDF2: second order, L-stable; the first step falls back to Backward Euler
+    };
+
+    struct TransientOptions {
+        double durationSeconds = 0.0;
+        double timestepSeconds = 0.0;    // integration step, or the output grid spacing when adaptive
+        IntegrationMethod method = IntegrationMethod::BackwardEuler;
+        bool adaptive = false;
+        // Adaptive step bounds; 0 picks timestepSeconds * 1e-4 and durationSeconds / 10.
+        double minTimestepSeconds = 0.0;
+        double maxTimestepSeconds = 0.0;
+        double relativeTolerance = 1e-3; // per-step LTE bound on capacitor voltages
+        double absoluteTolerance = 1e-6;
+    };
+
+    struct TransientStatistics {
+        std::size_t acceptedSteps = 0;
+        std::size_t rejectedSteps = 0;
+        std::size_t factorizations = 0;
+    };
+
+    /**
+     * Receives transient samples as Circuit::simulateTransient produces them.
+     * begin() is called once before the first sample, consume() once per timestep with
+     * one value per layout column, end() after the last sample. The span is only valid
+     * for the duration of the call.
+     */
+    class TransientSink {
+    public:
+        virtual ~TransientSink() = default;
+
+        virtual void begin(const TransientLayout& layout) = 0;
+        virtual void consume(double time, std::span<const double> values) = 0;
+        virtual void end() {}
+    };
+
+    // Keeps every sample in memory as a TransientResult.
+    class TransientCollector : public TransientSink {
+    public:
+        void begin(const TransientLayout& layout) override;
+        void consume(double time, std::span<const double> values) override;
+
+        [[nodiscard]] const TransientResult& result() const { return collected; }
+        TransientResult takeResult() { return std::move(collected); }
+
+    private:
+        TransientResult collected;
+    };
+
+    // Forwards every n-th sample (plus the final one) to another sink.
+    class DecimatingSink : public TransientSink {
+    public:
+        DecimatingSink(TransientSink& downstream, std::size_t every);
+
+        void begin(const TransientLayout& layout) override;
+        void consume(double time, std::span<const double> values) override;
+        void end() override;
+
+    private:
+        TransientSink& downstream;
+        std::size_t every;
+        std::size_t seen = 0;
+        bool lastForwarded = false;
+        double lastTime = 0.0;
+        std::vector<double> lastValues;
+    };
+
+    /**
+     * Streams samples to a little-endian binary file with constant memory:
+     *   "CXTR" | u32 version | u64 columns | u64 samples | f64 timestep | u32 reference | u32 nodeIds[columns]
+     * followed by one record per sample: f64 time | f64 values[columns].
+     * All fields are written little-endian regardless of the host byte order.
+     * The sample count is patched in end(). Throws std::runtime_error if the file cannot be written.
+     */
+    class BinaryFileSink : public TransientSink {
+    public:
+        explicit BinaryFileSink(std::string path);
+        ~BinaryFileSink() override;
+
+        void begin(const TransientLayout& layout) override;
+        void consume(double time, std::span<const double> values) override;
+        void end() override;
+
+        [[nodiscard]] std::uint64_t samplesWritten() const { return written; }
+
+    private:
+        struct Stream; // the open file, kept out of this header
+
+        std::string path;
+        std::unique_ptr<Stream> stream;
+        std::uint64_t written = 0;
+    };
+
+    // Hands every sample to a user callback.
+    class CallbackSink : public TransientSink {
+    public:
+        using Callback = std::function<void(double, std::span<const double>)>;
+
+        explicit CallbackSink(Callback callback, std::function<void(const TransientLayout&)> onBegin = {})
+            : callback(std::move(callback)), onBegin(std::move(onBegin)) {}
+
+        void begin(const TransientLayout& layout) override {
+            if (onBegin) {
+                onBegin(layout);
+            }
+        }
+        void consume(double time, std::span<const double> values) override { callback(time, values); }
+
+    private:
+        Callback callback;
+        std::function<void(const TransientLayout&)> onBegin;
+    };
+}
+
+#endif //CIRCUITX_TRANSIENT_HPP
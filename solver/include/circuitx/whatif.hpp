@@ -0,0 +1,35 @@
+#ifndef CIRCUITX_WHATIF_HPP
+#define CIRCUITX_WHATIF_HPP
+
+#include <Eigen/Core>
+
+#include <cstddef>
+
+namespace circuitx {
+    // New value (R, C, V or I) for one element (index into Circuit::elementsView()).
+    struct ValueChange {
+        std::size_t elementIndex = 0;
+        double value = 0.0;
+    };
+
+    struct WhatIfOptions {
+        // Up to this many matrix-changing elements are applied as a low-rank update of the existing
+        // factorization; beyond it a scratch copy of the matrix is factored instead.
+        std::size_t maxRank = 16;
+    };
+
+    enum class WhatIfMethod {
+        LowRank,     // Woodbury update: rank + 1 solves with the kept factorization and a rank x rank system
+        Refactored,  // too many changes, or a singular update (e.g. opening the only path to a node)
+        Iterative    // iterative backend: CG on the changed matrix with the kept preconditioner
+    };
+
+    struct WhatIfResult {
+        bool solved = false;
+        WhatIfMethod method = WhatIfMethod::LowRank;
+        std::size_t rank = 0;     // changed elements that enter the matrix (resistors); sources only move the RHS
+        Eigen::VectorXd solution; // ordered like Circuit::solve()
+    };
+}
+
+#endif //CIRCUITX_WHATIF_HPP
@@ -0,0 +1,137 @@
+#include "AcAnalysis.h"
+
+#include "../parallel/ParallelFor.h"
+
+#include <Eigen/Dense>
+#include <Eigen/SparseLU>
+#include <Eigen/SparseQR>
+
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <numbers>
+
+namespace circuitx {
+    namespace {
+        using Complex = std::complex<double>;
+        using ComplexSparse = Eigen::SparseMatrix<Complex>;
+
+        struct AcWorkspace {
+            ComplexSparse sparse;
+            Eigen::MatrixXcd dense;
+            Eigen::SparseLU<ComplexSparse, Eigen::COLAMDOrdering<int>> lu;
+            Eigen::SparseQR<ComplexSparse, Eigen::COLAMDOrdering<int>> qr;
+            Eigen::ColPivHouseholderQR<Eigen::MatrixXcd> denseQr;
+            bool analyzed = false;
+        };
+    }
+
+    std::vector<double> acFrequencies(const AcOptions& options) {
+        std::vector<double> frequencies;
+        if (!(options.startHz > 0.0) || !(options.stopHz >= options.startHz) || !std::isfinite(options.stopHz)) {
+            return frequencies;
+        }
+        if (options.logarithmic) {
+            const double decades = std::log10(options.stopHz / options.startHz);
+            const double stepCount =
+                std::ceil(decades * static_cast<double>(std::max<std::size_t>(options.pointsPerDecade, 1)) - 1e-9);
+            if (!(stepCount < static_cast<double>(AcOptions::maxPoints))) {
+                return frequencies;
+            }
+            const auto steps = static_cast<std::size_t>(std::max(stepCount, 0.0));
+            frequencies.reserve(steps + 1);
+            for (std::size_t i = 0; i <= steps; ++i) {
+                const double fraction = steps == 0 ? 0.0 : static_cast<double>(i) / static_cast<double>(steps);
+                frequencies.push_back(options.startHz * std::pow(10.0, decades * fraction));
+            }
+        } else {
+            const std::size_t count = std::max<std::size_t>(options.points, 1);
+            if (count > AcOptions::maxPoints) {
+                return frequencies;
+            }
+            frequencies.reserve(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                const double fraction = count == 1 ? 0.0 : static_cast<double>(i) / static_cast<double>(count - 1);
+                frequencies.push_back(options.startHz + (options.stopHz - options.startHz) * fraction);
+            }
+        }
+        return frequencies;
+    }
+
+    bool runAcSweep(const StampProgram& program,
+        const Eigen::VectorXd& excitation,
+        std::size_t nodeUnknowns,
+        unsigned threads,
+        AcResult& result) {
+        const std::size_t points = result.frequencies.size();
+        const int size = program.systemSize();
+        const bool sparse = program.isSparse();
+        const std::size_t valueCount = sparse
+            ? static_cast<std::size_t>(program.pattern().nonZeros())
+            : static_cast<std::size_t>(size) * static_cast<std::size_t>(size);
+
+        // G from the DC stamps, C from the companion stamps at unit scale: A(w) = G + jwC, slot by slot.
+        std::vector<double> conductance(valueCount);
+        std::vector<double> capacitance(valueCount);
+        Eigen::VectorXd unusedRhs;
+        program.assemble(conductance.data(), unusedRhs, 0.0);
+        program.assemble(capacitance.data(), unusedRhs, 1.0);
+        for (std::size_t k = 0; k < valueCount; ++k) {
+            capacitance[k] -= conductance[k];
+        }
+
+        const Eigen::VectorXcd rhs = excitation.cast<Complex>();
+        const unsigned workers = resolveWorkerCount(threads, points);
+        std::vector<AcWorkspace> workspaces(workers);
+        std::atomic<bool> allSolved{true};
+
+        parallelFor(points, workers, [&](std::size_t point, unsigned worker) {
+            AcWorkspace& ws = workspaces[worker];
+            const double omega = 2.0 * std::numbers::pi * result.frequencies[point];
+
+            Complex* values = nullptr;
+            if (sparse) {
+                if (ws.sparse.nonZeros() != program.pattern().nonZeros()) {
+                    ws.sparse = program.pattern().cast<Complex>();
+                }
+                values = ws.sparse.valuePtr();
+            } else {
+                ws.dense.resize(size, size);
+                values = ws.dense.data();
+            }
+            for (std::size_t k = 0; k < valueCount; ++k) {
+                values[k] = Complex(conductance[k], omega * capacitance[k]);
+            }
+
+            Eigen::VectorXcd solution;
+            if (sparse) {
+                if (!ws.analyzed) {
+                    ws.lu.analyzePattern(ws.sparse);
+                    ws.analyzed = true;
+                }
+                ws.lu.factorize(ws.sparse);
+                if (ws.lu.info() == Eigen::Success) {
+                    solution = ws.lu.solve(rhs);
+                } else {
+                    ws.qr.compute(ws.sparse);
+                    if (ws.qr.info() != Eigen::Success) {
+                        allSolved = false;
+                        return;
+                    }
+                    solution = ws.qr.solve(rhs);
+                }
+            } else {
+                ws.denseQr.compute(ws.dense);
+                solution = ws.denseQr.solve(rhs);
+            }
+
+            for (std::size_t node = 0; node < nodeUnknowns; ++node) {
+                const Complex value = solution(static_cast<Eigen::Index>(node));
+                result.magnitude[node * points + point] = std::abs(value);
+                result.phaseDegrees[node * points + point] = std::arg(value) * 180.0 / std::numbers::pi;
+            }
+        });
+
+        return allSolved;
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef CIRCUITX_ACANALYSIS_H
+#define CIRCUITX_ACANALYSIS_H
+
+#include "../stamping/StampProgram.h"
+
+#include <circuitx/ac.hpp>
+
+#include <vector>
+
+namespace circuitx {
+    // The frequency grid of options; empty for invalid bounds or more than AcOptions::maxPoints points.
+    std::vector<double> acFrequencies(const AcOptions& options);
+
+    /**
+     * Solves (G + j*2*pi*f*C) x = excitation for every frequency and writes node magnitude/phase
+     * (node-major, nodeUnknowns columns) into the result. G and C come from the compiled stamp
+     * program, so every frequency shares one sparsity pattern. Frequencies are spread over a
+     * worker pool; each worker runs the symbolic analysis once and only refactors numerically.
+     * Returns false if any frequency could not be factored.
+     */
+    bool runAcSweep(const StampProgram& program,
+        const Eigen::VectorXd& excitation,
+        std::size_t nodeUnknowns,
+        unsigned threads,
+        AcResult& result);
+}
+
+#endif //CIRCUITX_ACANALYSIS_H
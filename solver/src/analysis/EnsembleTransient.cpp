@@ -0,0 +1,484 @@
+#include "EnsembleTransient.h"
+
+#include "../parallel/ParallelFor.h"
+#include "../solving/BatchedCircuitLu.h"
+#include "../solving/LinearSolver.h"
+#include "../transient/CompanionSystem.h"
+#include "../transient/TransientIntegrator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <optional>
+
+namespace circuitx {
+    namespace {
+        // One worker's state for a lane group: the batched factorization and every per-row vector with a lane
+        // per member.
+        template <int Width>
+        struct LaneWorkspace {
+            using Lane = Lanes<Width>;
+
+            BatchedCircuitLu<Width> lu;
+            bool analyzed = false;
+            SparseMatrix scratch;
+            Eigen::VectorXd rhs;
+            std::vector<Lane> values;
+            std::vector<Lane> baseZ;
+            std::vector<Lane> z;
+            std::vector<Lane> solution;
+            std::vector<Lane> capacitance;
+            std::vector<Lane> prevVoltage;
+            std::vector<Lane> olderVoltage;
+            std::vector<Lane> prevCurrent;
+            std::vector<Lane> staged; // [sample % stagedSamples][column]
+        };
+
+        // Samples a lane group stages per waveform before writing them out: one cache line of each waveform,
+        // instead of one scattered double per (member, column) and sample.
+        constexpr std::size_t stagedSamples = 8;
+
+        struct Workspace {
+            SparseMatrix sparse;
+            Eigen::MatrixXd dense;
+            Eigen::VectorXd rhs;
+            LinearSolver dcSolver;
+            LinearSolver transientSolver;
+            bool configured = false;
+            LaneWorkspace<4> lanes4;
+            LaneWorkspace<8> lanes8;
+        };
+
+        // Scatters the observed rows of every sample into one member's node-major waveform.
+        class MemberSink : public TransientSink {
+        public:
+            MemberSink(const std::vector<int>& rows, std::size_t samples, double* out)
+                : rows(rows), samples(samples), out(out) {}
+
+            void begin(const TransientLayout&) override {}
+
+            void consume(double, std::span<const double> values) override {
+                if (sample == samples) {
+                    finite = false;
+                    return;
+                }
+                for (std::size_t c = 0; c < rows.size(); ++c) {
+                    const double value = rows[c] >= 0 ? values[static_cast<std::size_t>(rows[c])] : 0.0;
+                    finite = finite && std::isfinite(value);
+                    out[c * samples + sample] = value;
+                }
+                ++sample;
+            }
+
+            [[nodiscard]] bool complete() const { return finite && sample == samples; }
+
+        private:
+            const std::vector<int>& rows;
+            std::size_t samples;
+            double* out;
+            std::size_t sample = 0;
+            bool finite = true;
+        };
+
+        // The lanes of solution row `row`, or of ground (all zero) for row < 0.
+        template <int Width>
+        const Lanes<Width>& laneRow(const std::vector<Lanes<Width>>& solution, int row) {
+            static constexpr Lanes<Width> ground{};
+            return row >= 0 ? solution[static_cast<std::size_t>(row)] : ground;
+        }
+
+        /**
+         * The fixed-step transient of members [first, first + count) (count <= Width) as the lanes of one
+         * batched system: CompanionSystem with every value widened to a lane. All lanes take the same steps,
+         * so they refactor together. Returns the mask of lanes that ran to the end with finite outputs;
+         * the caller reruns the others member by member (their own pivoting, or the QR fallback).
+         */
+        template <int Width>
+        unsigned runLaneGroup(const StampProgram& program,
+            const std::vector<EnsembleMember>& members,
+            std::size_t first,
+            std::size_t count,
+            const EnsembleOptions& options,
+            const SolverOptions& solverOptions,
+            const std::vector<int>& observedRows,
+            const std::vector<double*>& outputs,
+            LaneWorkspace<Width>& ws) {
+            using Lane = Lanes<Width>;
+            if (!ws.analyzed) {
+                ws.analyzed = true;
+                ws.lu.analyze(program.pattern(), solverOptions.ordering);
+            }
+            if (!ws.lu.isAnalyzed()) {
+                return 0;
+            }
+
+            const auto n = static_cast<std::size_t>(program.systemSize());
+            const auto slots = static_cast<std::size_t>(program.pattern().nonZeros());
+            ws.values.resize(slots);
+            ws.baseZ.resize(n);
+            ws.z.resize(n);
+            ws.solution.resize(n);
+
+            // Unused lanes repeat the last member, so the whole register stays meaningful.
+            auto memberOf = [&](int lane) -> const EnsembleMember& {
+                return members[first + std::min(static_cast<std::size_t>(lane), count - 1)];
+            };
+            auto factorLanes = [&](double scale) {
+                for (int lane = 0; lane < Width; ++lane) {
+                    program.assemble(ws.scratch, ws.rhs, memberOf(lane).coefficients, scale);
+                    const double* values = ws.scratch.valuePtr();
+                    for (std::size_t p = 0; p < slots; ++p) {
+                        ws.values[p].v[lane] = values[p];
+                    }
+                    for (std::size_t r = 0; r < n; ++r) {
+                        ws.baseZ[r].v[lane] = ws.rhs(static_cast<Eigen::Index>(r));
+                    }
+                }
+                return ws.lu.factorize(ws.values.data());
+            };
+
+            unsigned active = factorLanes(0.0) & ((1u << count) - 1);
+            ws.lu.solve(ws.baseZ.data(), ws.solution.data());
+            for (int lane = 0; lane < Width; ++lane) {
+                for (std::size_t r = 0; r < n && (active >> lane & 1u); ++r) {
+                    if (!std::isfinite(ws.solution[r].v[lane])) {
+                        active &= ~(1u << lane);
+                    }
+                }
+            }
+            if (active == 0) {
+                return 0;
+            }
+
+            // The seed is a DC operating point, so no current flows through the capacitors. Members may zero
+            // different capacitors, so every lane indexes the unfiltered template; a capacitance that is not
+            // positive is 0 here and carries no history current, like a capacitor CompanionSystem leaves out.
+            const std::vector<CapacitorState>& capacitors = program.capacitorTemplates();
+            const std::vector<std::size_t>& capacitorElements = program.capacitorElementIndices();
+            ws.capacitance.resize(capacitors.size());
+            ws.prevVoltage.resize(capacitors.size());
+            ws.olderVoltage.resize(capacitors.size());
+            ws.prevCurrent.assign(capacitors.size(), Lane{});
+            for (int lane = 0; lane < Width; ++lane) {
+                const std::vector<double>& coefficients = memberOf(lane).coefficients;
+                for (std::size_t i = 0; i < capacitors.size(); ++i) {
+                    const double capacitance = coefficients[capacitorElements[i]];
+                    ws.capacitance[i].v[lane] = capacitance > 0.0 ? capacitance : 0.0;
+                }
+            }
+            auto capacitorVoltages = [&](std::size_t i, Lane& out) {
+                const Lane& a = laneRow(ws.solution, capacitors[i].aIdx);
+                const Lane& b = laneRow(ws.solution, capacitors[i].bIdx);
+                for (int lane = 0; lane < Width; ++lane) {
+                    out.v[lane] = a.v[lane] - b.v[lane];
+                }
+            };
+            for (std::size_t i = 0; i < capacitors.size(); ++i) {
+                capacitorVoltages(i, ws.prevVoltage[i]);
+                ws.olderVoltage[i] = ws.prevVoltage[i];
+            }
+
+            const std::size_t samples = transientSampleCount(options.transient);
+            const std::size_t columns = observedRows.size();
+            ws.staged.resize(columns * stagedSamples);
+            auto emitSample = [&](std::size_t sample) {
+                // x - x is 0 for finite x and NaN otherwise, so a lane's sum stays 0 only while it is finite.
+                Lane check{};
+                const std::size_t slot = sample % stagedSamples;
+                Lane* staged = ws.staged.data() + slot * columns;
+                for (std::size_t c = 0; c < columns; ++c) {
+                    const Lane& value = laneRow(ws.solution, observedRows[c]);
+                    staged[c] = value;
+                    for (int lane = 0; lane < Width; ++lane) {
+                        check.v[lane] += value.v[lane] - value.v[lane];
+                    }
+                }
+                for (std::size_t l = 0; l < count; ++l) {
+                    if (check.v[l] != 0.0) {
+                        active &= ~(1u << l);
+                    }
+                }
+
+                if (slot + 1 == stagedSamples || sample + 1 == samples) {
+                    const std::size_t base = sample - slot;
+                    for (std::size_t l = 0; l < count; ++l) {
+                        for (std::size_t c = 0; c < columns; ++c) {
+                            double* out = outputs[l] + c * samples + base;
+                            for (std::size_t s = 0; s <= slot; ++s) {
+                                out[s] = ws.staged[s * columns + c].v[l];
+                            }
+                        }
+                    }
+                }
+            };
+            emitSample(0);
+
+            const IntegrationMethod method = options.transient.method;
+            const bool trapezoidal = method == IntegrationMethod::Trapezoidal;
+            const double step = options.transient.timestepSeconds;
+            double factoredScale = 0.0;
+            double lastStep = 0.0;
+            for (std::size_t sample = 1; sample < samples && active != 0; ++sample) {
+                const CompanionCoefficients c = companionCoefficients(method, step, lastStep);
+                if (c.a0 != factoredScale) {
+                    active &= factorLanes(c.a0);
+                    factoredScale = c.a0;
+                }
+
+                std::copy(ws.baseZ.begin(), ws.baseZ.end(), ws.z.begin());
+                for (std::size_t i = 0; i < capacitors.size(); ++i) {
+                    const Lane& capacitance = ws.capacitance[i];
+                    const double keep = trapezoidal ? 1.0 : 0.0;
+                    Lane historyCurrent;
+                    for (int lane = 0; lane < Width; ++lane) {
+                        historyCurrent.v[lane] = -capacitance.v[lane]
+                            * (c.a1 * ws.prevVoltage[i].v[lane] + c.a2 * ws.olderVoltage[i].v[lane])
+                            + keep * ws.prevCurrent[i].v[lane];
+                    }
+                    if (capacitors[i].aIdx >= 0) {
+                        Lane& a = ws.z[static_cast<std::size_t>(capacitors[i].aIdx)];
+                        for (int lane = 0; lane < Width; ++lane) {
+                            a.v[lane] += historyCurrent.v[lane];
+                        }
+                    }
+                    if (capacitors[i].bIdx >= 0) {
+                        Lane& b = ws.z[static_cast<std::size_t>(capacitors[i].bIdx)];
+                        for (int lane = 0; lane < Width; ++lane) {
+                            b.v[lane] -= historyCurrent.v[lane];
+                        }
+                    }
+                }
+                ws.lu.solve(ws.z.data(), ws.solution.data());
+                emitSample(sample);
+
+                for (std::size_t i = 0; i < capacitors.size(); ++i) {
+                    Lane next;
+                    capacitorVoltages(i, next);
+                    const double keep = trapezoidal ? 1.0 : 0.0;
+                    for (int lane = 0; lane < Width; ++lane) {
+                        ws.prevCurrent[i].v[lane] = ws.capacitance[i].v[lane]
+                                * (c.a0 * next.v[lane] + c.a1 * ws.prevVoltage[i].v[lane] + c.a2 * ws.olderVoltage[i].v[lane])
+                            - keep * ws.prevCurrent[i].v[lane];
+                    }
+                    ws.olderVoltage[i] = ws.prevVoltage[i];
+                    ws.prevVoltage[i] = next;
+                }
+                lastStep = step;
+            }
+            return active;
+        }
+
+        // Welford moments and extrema per (column, sample); every member adds a whole waveform, and partial
+        // accumulators are merged pairwise (Chan et al.).
+        struct Accumulator {
+            std::size_t count = 0;
+            std::vector<double> mean;
+            std::vector<double> m2;
+            std::vector<double> min;
+            std::vector<double> max;
+
+            explicit Accumulator(std::size_t values)
+                : mean(values, 0.0),
+                  m2(values, 0.0),
+                  min(values, std::numeric_limits<double>::max()),
+                  max(values, std::numeric_limits<double>::lowest()) {}
+
+            void add(const std::vector<double>& waveform) {
+                ++count;
+                const double weight = 1.0 / static_cast<double>(count);
+                for (std::size_t i = 0; i < waveform.size(); ++i) {
+                    const double delta = waveform[i] - mean[i];
+                    mean[i] += delta * weight;
+                    m2[i] += delta * (waveform[i] - mean[i]);
+                    min[i] = std::min(min[i], waveform[i]);
+                    max[i] = std::max(max[i], waveform[i]);
+                }
+            }
+
+            void merge(const Accumulator& other) {
+                if (other.count == 0) {
+                    return;
+                }
+                const auto total = static_cast<double>(count + other.count);
+                const double weight = static_cast<double>(other.count) / total;
+                const double cross = static_cast<double>(count) * static_cast<double>(other.count) / total;
+                for (std::size_t i = 0; i < mean.size(); ++i) {
+                    const double delta = other.mean[i] - mean[i];
+                    mean[i] += delta * weight;
+                    m2[i] += other.m2[i] + delta * delta * cross;
+                    min[i] = std::min(min[i], other.min[i]);
+                    max[i] = std::max(max[i], other.max[i]);
+                }
+                count += other.count;
+            }
+        };
+    }
+
+    EnsembleOutcome runEnsembleTransient(const StampProgram& program,
+        const std::vector<EnsembleMember>& members,
+        const EnsembleOptions& options,
+        const SolverOptions& solverOptions,
+        const std::vector<int>& observedRows,
+        std::size_t nodeUnknowns) {
+        EnsembleOutcome outcome;
+        const std::size_t samples = transientSampleCount(options.transient);
+        const std::size_t values = observedRows.size() * samples;
+        outcome.solved.assign(members.size(), 0);
+        if (members.empty() || values == 0) {
+            return outcome;
+        }
+
+        // Lane groups need one step sequence and a pattern-preserving factorization.
+        const int width = options.transient.adaptive || !program.isSparse()
+                || solverOptions.factorization != SparseFactorization::CircuitLu
+            ? 0
+            : options.simdLanes >= 8 ? 8 : options.simdLanes >= 4 ? 4 : 0;
+        const std::size_t groupSize = width > 0 ? static_cast<std::size_t>(width) : 1;
+        const std::size_t tasks = (members.size() + groupSize - 1) / groupSize;
+        const unsigned workers = resolveWorkerCount(options.threads, tasks);
+        std::vector<Workspace> workspaces(workers);
+
+        // Runs one member into out[0, values); false if it has no finite DC point or transient.
+        auto runMember = [&](std::size_t index, unsigned worker, double* out) {
+            const EnsembleMember& member = members[index];
+            Workspace& ws = workspaces[worker];
+            if (!ws.configured) {
+                for (LinearSolver* solver : {&ws.dcSolver, &ws.transientSolver}) {
+                    solver->setFactorization(solverOptions.factorization);
+                    solver->setOrdering(solverOptions.ordering);
+                }
+                ws.configured = true;
+            }
+            ws.dcSolver.setSymmetricPositiveDefinite(member.symmetric);
+            ws.transientSolver.setSymmetricPositiveDefinite(member.symmetric);
+
+            bool factored = false;
+            if (program.isSparse()) {
+                program.assemble(ws.sparse, ws.rhs, member.coefficients);
+                factored = ws.dcSolver.factorize(ws.sparse);
+            } else {
+                program.assemble(ws.dense, ws.rhs, member.coefficients);
+                factored = ws.dcSolver.factorize(ws.dense);
+            }
+            if (!factored) {
+                return false;
+            }
+            const Eigen::VectorXd steadyState = ws.dcSolver.solve(ws.rhs);
+            if (!steadyState.allFinite()) {
+                return false;
+            }
+
+            CompanionSystem system(program, ws.transientSolver, ws.sparse, ws.dense, options.transient.method,
+                member.coefficients);
+            system.seed(steadyState);
+            MemberSink sink(observedRows, samples, out);
+            integrateTransient(system, steadyState, options.transient, nodeUnknowns + 1, sink);
+            return sink.complete();
+        };
+
+        // Runs the members of one task into outputs[i]; returns how many went through a lane group.
+        std::vector<std::vector<double*>> taskOutputs(workers);
+        auto runTask = [&](std::size_t task, unsigned worker, std::vector<double*>& outputs) {
+            const std::size_t first = task * groupSize;
+            const std::size_t count = outputs.size();
+            unsigned batched = 0;
+            if (width == 8) {
+                batched = runLaneGroup(program, members, first, count, options, solverOptions, observedRows, outputs,
+                    workspaces[worker].lanes8);
+            } else if (width == 4) {
+                batched = runLaneGroup(program, members, first, count, options, solverOptions, observedRows, outputs,
+                    workspaces[worker].lanes4);
+            }
+            std::size_t laneSolved = 0;
+            for (std::size_t i = 0; i < count; ++i) {
+                if (batched >> i & 1u) {
+                    outcome.solved[first + i] = 1;
+                    ++laneSolved;
+                } else {
+                    outcome.solved[first + i] = runMember(first + i, worker, outputs[i]);
+                }
+            }
+            return laneSolved;
+        };
+        std::mutex mergeMutex;
+        auto taskSize = [&](std::size_t task) { return std::min(groupSize, members.size() - task * groupSize); };
+
+        if (options.output == EnsembleOutput::Waveforms) {
+            outcome.waveforms.assign(members.size() * values, 0.0);
+            parallelFor(tasks, workers, [&](std::size_t task, unsigned worker) {
+                std::vector<double*>& outputs = taskOutputs[worker];
+                outputs.clear();
+                for (std::size_t i = 0; i < taskSize(task); ++i) {
+                    outputs.push_back(outcome.waveforms.data() + (task * groupSize + i) * values);
+                }
+                const std::size_t laneSolved = runTask(task, worker, outputs);
+                for (std::size_t i = 0; i < outputs.size(); ++i) {
+                    if (!outcome.solved[task * groupSize + i]) {
+                        std::fill_n(outputs[i], values, 0.0);
+                    }
+                }
+                std::lock_guard lock(mergeMutex);
+                outcome.laneBatched += laneSolved;
+            });
+            return outcome;
+        }
+
+        // Every task folds its members into a partial accumulator; partials are merged in task order, so the
+        // statistics do not depend on the thread count. A task only starts within `window` tasks of the next
+        // merge, which bounds the partials waiting for a slow earlier task.
+        Accumulator accumulator(values);
+        const std::size_t window = 2 * static_cast<std::size_t>(workers);
+        std::vector<std::optional<Accumulator>> pending(tasks);
+        std::size_t nextMerge = 0;
+        std::condition_variable mergeAdvanced;
+        std::vector<std::vector<std::vector<double>>> taskWaveforms(workers);
+        parallelFor(tasks, workers, [&](std::size_t task, unsigned worker) {
+            {
+                std::unique_lock lock(mergeMutex);
+                mergeAdvanced.wait(lock, [&] { return task < nextMerge + window; });
+            }
+
+            const std::size_t first = task * groupSize;
+            std::vector<std::vector<double>>& waveforms = taskWaveforms[worker];
+            waveforms.resize(taskSize(task));
+            std::vector<double*>& outputs = taskOutputs[worker];
+            outputs.clear();
+            for (std::vector<double>& waveform : waveforms) {
+                waveform.resize(values);
+                outputs.push_back(waveform.data());
+            }
+            const std::size_t laneSolved = runTask(task, worker, outputs);
+            Accumulator partial(values);
+            for (std::size_t i = 0; i < waveforms.size(); ++i) {
+                if (outcome.solved[first + i]) {
+                    partial.add(waveforms[i]);
+                }
+            }
+
+            std::lock_guard lock(mergeMutex);
+            outcome.laneBatched += laneSolved;
+            pending[task] = std::move(partial);
+            for (; nextMerge < tasks && pending[nextMerge]; ++nextMerge) {
+                accumulator.merge(*pending[nextMerge]);
+                pending[nextMerge].reset();
+            }
+            mergeAdvanced.notify_all();
+        });
+
+        if (accumulator.count == 0) {
+            return outcome;
+        }
+        outcome.mean = std::move(accumulator.mean);
+        outcome.min = std::move(accumulator.min);
+        outcome.max = std::move(accumulator.max);
+        outcome.stddev.resize(values);
+        for (std::size_t i = 0; i < values; ++i) {
+            outcome.stddev[i] = accumulator.count > 1
+                ? std::sqrt(accumulator.m2[i] / static_cast<double>(accumulator.count - 1))
+                : 0.0;
+        }
+        return outcome;
+    }
+}
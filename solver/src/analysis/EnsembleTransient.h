@@ -0,0 +1,45 @@
+#ifndef CIRCUITX_ENSEMBLETRANSIENT_H
+#define CIRCUITX_ENSEMBLETRANSIENT_H
+
+#include "../stamping/StampProgram.h"
+
+#include <circuitx/circuit.hpp>
+
+#include <vector>
+
+namespace circuitx {
+    // One member's values, laid out like StampProgram::elementCoefficients().
+    struct EnsembleMember {
+        std::vector<double> coefficients;
+        bool symmetric = false; // factor with Cholesky first (positive R/C, no voltage sources)
+    };
+
+    struct EnsembleOutcome {
+        std::vector<char> solved;      // per member
+        std::size_t laneBatched = 0;   // members solved in a lane group
+        std::vector<double> waveforms; // EnsembleResult layout
+        std::vector<double> mean;
+        std::vector<double> stddev;
+        std::vector<double> min;
+        std::vector<double> max;
+    };
+
+    /**
+     * Runs the transient of every member on a worker pool. The topology (stamp program, column layout)
+     * is shared; each worker owns its matrix and its DC and transient solvers, so the symbolic analysis
+     * is done once per worker and only refactored numerically for its further members. Waveforms are
+     * written to each member's own slice; statistics are accumulated in member order as members finish
+     * (at most about one pending waveform per worker), so neither depends on the thread count.
+     * With options.simdLanes, fixed-step sparse CircuitLu runs take members in groups of 4 or 8 and
+     * solve each group as the SIMD lanes of one BatchedCircuitLu.
+     * observedRows holds the solution row of every output column, -1 for ground.
+     */
+    EnsembleOutcome runEnsembleTransient(const StampProgram& program,
+        const std::vector<EnsembleMember>& members,
+        const EnsembleOptions& options,
+        const SolverOptions& solverOptions,
+        const std::vector<int>& observedRows,
+        std::size_t nodeUnknowns);
+}
+
+#endif //CIRCUITX_ENSEMBLETRANSIENT_H
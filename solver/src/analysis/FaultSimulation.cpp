@@ -0,0 +1,154 @@
+#include "FaultSimulation.h"
+
+#include "../parallel/ParallelFor.h"
+#include "../solving/LowRankUpdate.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace circuitx {
+    namespace {
+        // Right-hand-side columns per block solve, capped so a block stays around 32 MB.
+        constexpr std::size_t maxBlockColumns = 32;
+        constexpr std::size_t blockValueBudget = std::size_t{1} << 22;
+        // Sherman-Morrison is abandoned when 1 + delta u^T z keeps less than this share of its terms.
+        constexpr double cancellationLimit = 1e-8;
+
+        struct Workspace {
+            Eigen::MatrixXd block;
+            SparseMatrix sparse;
+            Eigen::MatrixXd dense;
+            LinearSolver solver;
+            bool configured = false;
+        };
+
+        void addRankOne(const StampProgram::RankOneStamp& u, double delta, SparseMatrix& matrix) {
+            for (int r = 0; r < u.count; ++r) {
+                for (int c = 0; c < u.count; ++c) {
+                    matrix.coeffRef(u.index[r], u.index[c]) += delta * u.weight[r] * u.weight[c];
+                }
+            }
+        }
+
+        void addRankOne(const StampProgram::RankOneStamp& u, double delta, Eigen::MatrixXd& matrix) {
+            for (int r = 0; r < u.count; ++r) {
+                for (int c = 0; c < u.count; ++c) {
+                    matrix(u.index[r], u.index[c]) += delta * u.weight[r] * u.weight[c];
+                }
+            }
+        }
+
+        // Solves the faulted system explicitly; false if it has no finite solution.
+        bool refactorFault(const FaultBase& base, const FaultTarget& target, double delta, Workspace& ws,
+            Eigen::VectorXd& x) {
+            if (!ws.configured) {
+                ws.solver.setFactorization(base.options.factorization);
+                ws.solver.setOrdering(base.options.ordering);
+                ws.solver.setSymmetricPositiveDefinite(base.symmetric);
+                ws.configured = true;
+            }
+            bool factored = false;
+            if (base.sparse != nullptr) {
+                ws.sparse = *base.sparse;
+                addRankOne(target.u, delta, ws.sparse);
+                factored = ws.solver.factorize(ws.sparse);
+            } else {
+                ws.dense = *base.dense;
+                addRankOne(target.u, delta, ws.dense);
+                factored = ws.solver.factorize(ws.dense);
+            }
+            if (!factored) {
+                return false;
+            }
+            x = ws.solver.solve(base.rhs);
+            return x.allFinite();
+        }
+    }
+
+    FaultOutcome runFaultSimulation(const FaultBase& base,
+        const std::vector<FaultTarget>& targets,
+        const std::vector<int>& observedRows,
+        const std::vector<unsigned int>& observedIds,
+        const FaultOptions& options) {
+        FaultOutcome outcome;
+        const auto n = static_cast<std::size_t>(base.solution.size());
+        const std::size_t columns = observedRows.size();
+        if (targets.empty() || n == 0) {
+            return outcome;
+        }
+
+        const std::size_t blockColumns = std::clamp<std::size_t>(blockValueBudget / n, 1, maxBlockColumns);
+        const std::size_t tasks = (targets.size() + blockColumns - 1) / blockColumns;
+        const unsigned workers = resolveWorkerCount(options.threads, tasks);
+        std::vector<Workspace> workspaces(workers);
+        outcome.faults.resize(2 * targets.size());
+        if (options.keepDeltas) {
+            outcome.deltas.assign(outcome.faults.size() * columns, 0.0);
+        }
+
+        parallelFor(tasks, workers, [&](std::size_t task, unsigned worker) {
+            Workspace& ws = workspaces[worker];
+            const std::size_t first = task * blockColumns;
+            const std::size_t count = std::min(blockColumns, targets.size() - first);
+            ws.block.setZero(static_cast<Eigen::Index>(n), static_cast<Eigen::Index>(count));
+            for (std::size_t i = 0; i < count; ++i) {
+                const StampProgram::RankOneStamp& u = targets[first + i].u;
+                for (int t = 0; t < u.count; ++t) {
+                    ws.block(u.index[t], static_cast<Eigen::Index>(i)) += u.weight[t];
+                }
+            }
+            const Eigen::MatrixXd z = base.solver->solveBlock(ws.block);
+            Eigen::VectorXd faulted;
+
+            for (std::size_t i = 0; i < count; ++i) {
+                const FaultTarget& target = targets[first + i];
+                const auto zColumn = z.col(static_cast<Eigen::Index>(i));
+                const double uz = target.u.count > 0 ? dot(target.u, zColumn) : 0.0;
+                const double ux = target.u.count > 0 ? dot(target.u, base.solution) : 0.0;
+
+                for (int kind = 0; kind < 2; ++kind) {
+                    const std::size_t index = 2 * (first + i) + static_cast<std::size_t>(kind);
+                    const double delta = kind == 0 ? target.openDelta : target.shortDelta;
+                    FaultReport& report = outcome.faults[index];
+                    report.elementIndex = target.element;
+                    report.kind = kind == 0 ? FaultKind::Open : FaultKind::Short;
+                    report.solved = true;
+
+                    // dV at observed row r: scale * z(r) on the update path, or read from the refactored solution.
+                    double scale = 0.0;
+                    bool refactored = false;
+                    if (delta != 0.0 && target.u.count > 0) {
+                        const double denominator = 1.0 + delta * uz;
+                        if (std::abs(denominator) > cancellationLimit * (1.0 + std::abs(delta * uz))) {
+                            scale = -delta * ux / denominator;
+                        } else {
+                            report.solved = refactorFault(base, target, delta, ws, faulted);
+                            refactored = report.solved;
+                        }
+                    }
+                    if (!report.solved) {
+                        continue;
+                    }
+
+                    double* deltas = options.keepDeltas ? outcome.deltas.data() + index * columns : nullptr;
+                    for (std::size_t c = 0; c < columns; ++c) {
+                        const int row = observedRows[c];
+                        double change = 0.0;
+                        if (row >= 0) {
+                            change = refactored ? faulted(row) - base.solution(row) : scale * zColumn(row);
+                        }
+                        if (deltas != nullptr) {
+                            deltas[c] = change;
+                        }
+                        if (std::abs(change) > report.maxDelta) {
+                            report.maxDelta = std::abs(change);
+                            report.worstNodeId = observedIds[c];
+                        }
+                    }
+                    report.detected = report.maxDelta >= options.detectionThreshold;
+                }
+            }
+        });
+        return outcome;
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef CIRCUITX_FAULTSIMULATION_H
+#define CIRCUITX_FAULTSIMULATION_H
+
+#include "../solving/LinearSolver.h"
+#include "../stamping/StampProgram.h"
+
+#include <circuitx/faults.hpp>
+
+#include <vector>
+
+namespace circuitx {
+    // One element to fault: the conductance each fault adds across u = e_a - e_b.
+    struct FaultTarget {
+        std::size_t element = 0;
+        StampProgram::RankOneStamp u; // count 0 when both terminals are the same node
+        double openDelta = 0.0;
+        double shortDelta = 0.0;
+    };
+
+    // The factored fault-free DC system.
+    struct FaultBase {
+        const LinearSolver* solver = nullptr; // solved from every worker at once
+        const SparseMatrix* sparse = nullptr; // its values (one of sparse/dense), for faults that refactor
+        const Eigen::MatrixXd* dense = nullptr;
+        Eigen::VectorXd rhs;
+        Eigen::VectorXd solution;
+        SolverOptions options;                // factorization settings for refactored faults
+        bool symmetric = false;
+    };
+
+    struct FaultOutcome {
+        std::vector<FaultReport> faults; // open then short for every target
+        std::vector<double> deltas;      // fault-major, observed columns
+    };
+
+    /**
+     * Applies every fault as the rank-1 change delta * u u^T of the base matrix (Sherman-Morrison):
+     * dx = -z (delta u^T x) / (1 + delta u^T z) with z = A^-1 u, so the open and the short of an element
+     * share one solve. Targets are solved in column blocks on a worker pool. Faults whose denominator
+     * cancels (opening the only path to a node) are refactored on the worker instead.
+     * observedRows holds the solution row of every observed column, -1 for ground.
+     */
+    FaultOutcome runFaultSimulation(const FaultBase& base,
+        const std::vector<FaultTarget>& targets,
+        const std::vector<int>& observedRows,
+        const std::vector<unsigned int>& observedIds,
+        const FaultOptions& options);
+}
+
+#endif //CIRCUITX_FAULTSIMULATION_H
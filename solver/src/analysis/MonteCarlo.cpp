@@ -0,0 +1,251 @@
+#include "MonteCarlo.h"
+
+#include "../parallel/ParallelFor.h"
+#include "../solving/LinearSolver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numbers>
+
+namespace circuitx {
+    namespace {
+        // Trials whose values fix the histogram ranges before the streaming pass.
+        constexpr std::size_t kPilotTrials = 256;
+
+        // Chunk size depends only on the trial count, never on the worker count.
+        std::size_t chunkSizeFor(std::size_t trials) {
+            return std::max<std::size_t>(64, trials / 256);
+        }
+
+        std::uint64_t mix(std::uint64_t value) {
+            value += 0x9E3779B97F4A7C15ull;
+            value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+            value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+            return value ^ (value >> 31);
+        }
+
+        // Welford accumulator; merged pairwise (Chan et al.) in chunk order.
+        struct Moments {
+            std::size_t count = 0;
+            double mean = 0.0;
+            double m2 = 0.0;
+
+            void add(double value) {
+                ++count;
+                const double delta = value - mean;
+                mean += delta / static_cast<double>(count);
+                m2 += delta * (value - mean);
+            }
+
+            void merge(const Moments& other) {
+                if (other.count == 0) {
+                    return;
+                }
+                const auto total = static_cast<double>(count + other.count);
+                const double delta = other.mean - mean;
+                mean += delta * static_cast<double>(other.count) / total;
+                m2 += other.m2 + delta * delta * static_cast<double>(count) * static_cast<double>(other.count) / total;
+                count += other.count;
+            }
+        };
+
+        // Order-independent parts (extrema and histogram counts) are kept per worker and summed.
+        struct WorkerTallies {
+            std::vector<double> min;
+            std::vector<double> max;
+            std::vector<std::size_t> histogram; // nodes x bins
+        };
+
+        struct Workspace {
+            std::vector<double> coefficients;
+            SparseMatrix sparse;
+            Eigen::MatrixXd dense;
+            Eigen::VectorXd rhs;
+            LinearSolver solver;
+            bool configured = false;
+        };
+    }
+
+    TrialRandom::TrialRandom(std::uint64_t seed, std::uint64_t trial)
+        : state(mix(seed) ^ mix(trial + 0x632BE59BD9B4E019ull)) {}
+
+    std::uint64_t TrialRandom::next() {
+        state += 0x9E3779B97F4A7C15ull;
+        return mix(state);
+    }
+
+    double TrialRandom::uniform() {
+        return static_cast<double>(next() >> 11) * 0x1.0p-53;
+    }
+
+    double TrialRandom::symmetric() {
+        return 2.0 * uniform() - 1.0;
+    }
+
+    double TrialRandom::normal() {
+        // Box-Muller; 1 - u keeps the logarithm argument in (0, 1].
+        const double radius = std::sqrt(-2.0 * std::log(1.0 - uniform()));
+        return radius * std::cos(2.0 * std::numbers::pi * uniform());
+    }
+
+    MonteCarloOutcome runMonteCarlo(const StampProgram& program,
+        const std::vector<ToleranceTarget>& targets,
+        const MonteCarloOptions& options,
+        const SolverOptions& solverOptions,
+        bool symmetric,
+        std::size_t nodeUnknowns) {
+        MonteCarloOutcome outcome;
+        const std::size_t trials = options.trials;
+        const std::size_t bins = std::max<std::size_t>(options.histogramBins, 1);
+        const std::size_t columns = nodeUnknowns;
+        if (trials == 0 || columns == 0) {
+            return outcome;
+        }
+
+        const unsigned workers = resolveWorkerCount(options.threads, trials);
+        std::vector<Workspace> workspaces(workers);
+        const std::vector<double>& nominal = program.elementCoefficients();
+
+        // Solves one trial into values[0, columns); false if the perturbed system has no finite solution.
+        auto runTrial = [&](std::size_t trial, unsigned worker, double* values) {
+            Workspace& ws = workspaces[worker];
+            if (!ws.configured) {
+                ws.solver.setFactorization(solverOptions.factorization);
+                ws.solver.setOrdering(solverOptions.ordering);
+                ws.solver.setSymmetricPositiveDefinite(symmetric);
+                ws.configured = true;
+            }
+            ws.coefficients = nominal;
+            TrialRandom random(options.seed, trial);
+            for (const auto& target : targets) {
+                const double draw = options.distribution == ToleranceDistribution::Gaussian
+                    ? random.normal() * target.tolerance / 3.0
+                    : random.symmetric() * target.tolerance;
+                const double factor = std::max(1.0 + draw, 1e-6);
+                double& coefficient = ws.coefficients[target.element];
+                coefficient = target.reciprocal ? coefficient / factor : coefficient * factor;
+            }
+
+            bool factored = false;
+            if (program.isSparse()) {
+                program.assemble(ws.sparse, ws.rhs, ws.coefficients);
+                factored = ws.solver.factorize(ws.sparse);
+            } else {
+                program.assemble(ws.dense, ws.rhs, ws.coefficients);
+                factored = ws.solver.factorize(ws.dense);
+            }
+            if (!factored) {
+                return false;
+            }
+            const Eigen::VectorXd solution = ws.solver.solve(ws.rhs);
+            for (std::size_t i = 0; i < columns; ++i) {
+                values[i] = solution(static_cast<Eigen::Index>(i));
+                if (!std::isfinite(values[i])) {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        // Pilot pass: the first trials are kept whole to choose each node's histogram range.
+        const std::size_t pilot = std::min(trials, kPilotTrials);
+        std::vector<double> pilotValues(pilot * columns, 0.0);
+        std::vector<char> pilotSolved(pilot, 0);
+        parallelFor(pilot, workers, [&](std::size_t trial, unsigned worker) {
+            pilotSolved[trial] = runTrial(trial, worker, pilotValues.data() + trial * columns);
+        });
+
+        outcome.nodes.resize(columns);
+        for (std::size_t node = 0; node < columns; ++node) {
+            double low = std::numeric_limits<double>::max();
+            double high = std::numeric_limits<double>::lowest();
+            for (std::size_t trial = 0; trial < pilot; ++trial) {
+                if (pilotSolved[trial]) {
+                    low = std::min(low, pilotValues[trial * columns + node]);
+                    high = std::max(high, pilotValues[trial * columns + node]);
+                }
+            }
+            if (low > high) {
+                low = high = 0.0;
+            }
+            // Leave headroom for later trials; a degenerate range still gets a usable width.
+            const double pad = std::max(0.1 * (high - low), 1e-9 * std::max(1.0, std::abs(high)));
+            outcome.nodes[node].histogramMin = low - pad;
+            outcome.nodes[node].histogramMax = high + pad;
+        }
+
+        const std::size_t chunkSize = chunkSizeFor(trials);
+        const std::size_t chunks = (trials + chunkSize - 1) / chunkSize;
+        std::vector<Moments> chunkMoments(chunks * columns);
+        std::vector<std::size_t> chunkFailures(chunks, 0);
+        std::vector<WorkerTallies> tallies(workers);
+        for (auto& tally : tallies) {
+            tally.min.assign(columns, std::numeric_limits<double>::max());
+            tally.max.assign(columns, std::numeric_limits<double>::lowest());
+            tally.histogram.assign(columns * bins, 0);
+        }
+
+        parallelFor(chunks, workers, [&](std::size_t chunk, unsigned worker) {
+            WorkerTallies& tally = tallies[worker];
+            Moments* moments = chunkMoments.data() + chunk * columns;
+            std::vector<double> scratch(columns);
+            const std::size_t first = chunk * chunkSize;
+            const std::size_t last = std::min(trials, first + chunkSize);
+            for (std::size_t trial = first; trial < last; ++trial) {
+                const double* values = scratch.data();
+                bool solved = false;
+                if (trial < pilot) {
+                    solved = pilotSolved[trial];
+                    values = pilotValues.data() + trial * columns;
+                } else {
+                    solved = runTrial(trial, worker, scratch.data());
+                }
+                if (!solved) {
+                    ++chunkFailures[chunk];
+                    continue;
+                }
+                for (std::size_t node = 0; node < columns; ++node) {
+                    const double value = values[node];
+                    moments[node].add(value);
+                    tally.min[node] = std::min(tally.min[node], value);
+                    tally.max[node] = std::max(tally.max[node], value);
+
+                    const NodeStatistics& stats = outcome.nodes[node];
+                    const double position = (value - stats.histogramMin) / (stats.histogramMax - stats.histogramMin);
+                    const auto bin = static_cast<std::size_t>(
+                        std::clamp(position * static_cast<double>(bins), 0.0, static_cast<double>(bins - 1)));
+                    ++tally.histogram[node * bins + bin];
+                }
+            }
+        });
+
+        for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+            outcome.failedTrials += chunkFailures[chunk];
+        }
+        for (std::size_t node = 0; node < columns; ++node) {
+            Moments total;
+            for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+                total.merge(chunkMoments[chunk * columns + node]);
+            }
+
+            NodeStatistics& stats = outcome.nodes[node];
+            stats.mean = total.mean;
+            stats.stddev = total.count > 1 ? std::sqrt(total.m2 / static_cast<double>(total.count - 1)) : 0.0;
+            stats.min = std::numeric_limits<double>::max();
+            stats.max = std::numeric_limits<double>::lowest();
+            stats.histogram.assign(bins, 0);
+            for (const auto& tally : tallies) {
+                stats.min = std::min(stats.min, tally.min[node]);
+                stats.max = std::max(stats.max, tally.max[node]);
+                for (std::size_t bin = 0; bin < bins; ++bin) {
+                    stats.histogram[bin] += tally.histogram[node * bins + bin];
+                }
+            }
+            if (total.count == 0) {
+                stats.min = stats.max = 0.0;
+            }
+        }
+        return outcome;
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef CIRCUITX_MONTECARLO_H
+#define CIRCUITX_MONTECARLO_H
+
+#include "../stamping/StampProgram.h"
+
+#include <circuitx/montecarlo.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace circuitx {
+    // One perturbed element: its coefficient is scaled by (1 + d), or by 1 / (1 + d) when the
+    // coefficient is the reciprocal of the toleranced value (resistors stamp 1/R).
+    struct ToleranceTarget {
+        std::size_t element = 0;
+        double tolerance = 0.0;
+        bool reciprocal = false;
+    };
+
+    struct MonteCarloOutcome {
+        std::vector<NodeStatistics> nodes; // one per node unknown, in solution order
+        std::size_t failedTrials = 0;
+    };
+
+    /**
+     * Runs options.trials DC solves of `program` with perturbed coefficients on a worker pool.
+     * Trials are grouped into fixed-size chunks whose statistics are merged in chunk order, and every
+     * trial seeds its own random stream from (seed, trial index), so the outcome does not depend on
+     * the thread count. Each worker owns its matrix, solver and right-hand side; the symbolic
+     * analysis is done once per worker and reused for all of its trials. The solvers use the
+     * factorization and ordering of solverOptions, and Cholesky when `symmetric` (tolerances keep
+     * resistors positive, so the nominal circuit decides it for every trial).
+     */
+    MonteCarloOutcome runMonteCarlo(const StampProgram& program,
+        const std::vector<ToleranceTarget>& targets,
+        const MonteCarloOptions& options,
+        const SolverOptions& solverOptions,
+        bool symmetric,
+        std::size_t nodeUnknowns);
+
+    // Deterministic per-trial random stream (splitmix64).
+    class TrialRandom {
+    public:
+        TrialRandom(std::uint64_t seed, std::uint64_t trial);
+
+        std::uint64_t next();
+        double uniform();     // [0, 1)
+        double symmetric();   // [-1, 1)
+        double normal();      // standard normal
+
+    private:
+        std::uint64_t state;
+    };
+}
+
+#endif //CIRCUITX_MONTECARLO_H
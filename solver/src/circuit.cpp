@@ -5,7 +5,17 @@
 #include "circuitx/circuit.hpp"
 
 #include "stamping/MnaContext.h"
-#include "stamping/StampContext.h"
+#include "stamping/StampRegistry.h"
+#include "solving/LinearSolver.h"
+#include "solving/BlockSolver.h"
+#include "solving/LowRankUpdate.h"
+#include "solving/SolverCache.h"
+#include "transient/CompanionSystem.h"
+#include "transient/TransientIntegrator.h"
+#include "analysis/AcAnalysis.h"
+#include "analysis/EnsembleTransient.h"
+#include "analysis/FaultSimulation.h"
+#include "analysis/MonteCarlo.h"
 
 #include <Eigen/Dense>
 #include <nlohmann/json.hpp>
@@ -13,7 +23,10 @@
 #include <algorithm>
 #include <cctype>
 #include <cmath>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <type_traits>
 #include <unordered_map>
@@ -21,7 +34,11 @@
 namespace circuitx {
     namespace {
 
-        std::vector<Node> collectNodes(const std::vector<Node>& unitedNodes, const std::vector<Element>& elements) {
+        using SupernodeMap = std::function<unsigned int(unsigned int)>;
+
+        std::vector<Node> collectNodes(const std::vector<Node>& unitedNodes,
+            const std::vector<Element>& elements,
+            const SupernodeMap& supernodeOf) {
             std::vector<Node> nodesForContext;
             nodesForContext.reserve(unitedNodes.size());
             std::unordered_map<unsigned int, std::size_t> indexById;
@@ -49,8 +66,8 @@ namespace circuitx {
                     [&](const auto& component) {
                         using T = std::decay_t<decltype(component)>;
                         if constexpr (!std::is_same_v<T, Wire>) {
-                            ensureNode(component.a);
-                            ensureNode(component.b);
+                            ensureNode(supernodeOf(component.a));
+                            ensureNode(supernodeOf(component.b));
                         }
                     },
                     element);
@@ -88,38 +105,285 @@ namespace circuitx {
             return minIt != nodesForContext.end() ? minIt->id : 0;
         }
 
-        MnaContext buildMnaContext(const std::vector<Node>& unitedNodes, const std::vector<Element>& elements) {
+        MnaContext buildMnaContext(const std::vector<Node>& unitedNodes,
+            const std::vector<Element>& elements,
+            const SupernodeMap& supernodeOf) {
             MnaContext ctx;
-            ctx.nodesInContext = collectNodes(unitedNodes, elements);
+            ctx.nodesInContext = collectNodes(unitedNodes, elements, supernodeOf);
             ctx.groundId = detectGroundNode(ctx.nodesInContext);
 
-            for (const auto& node : ctx.nodesInContext) {
+            const std::size_t slotCount = ctx.nodesInContext.size();
+            ctx.slotByNodeId.reserve(slotCount);
+            ctx.equationBySlot.assign(slotCount, -1);
+            for (std::size_t slot = 0; slot < slotCount; ++slot) {
+                const auto& node = ctx.nodesInContext[slot];
+                ctx.slotByNodeId[node.id] = static_cast<int>(slot);
                 if (node.id == ctx.groundId) {
                     continue;
                 }
-                ctx.nodeToIndex[node.id] = ctx.nodeUnknowns++;
+                ctx.equationBySlot[slot] = ctx.nodeUnknowns++;
                 ctx.indexToNodeId.push_back(node.id);
             }
 
+            ctx.terminals.resize(elements.size());
+            ctx.voltageRowByElement.assign(elements.size(), -1);
             for (std::size_t idx = 0; idx < elements.size(); ++idx) {
-                if (std::holds_alternative<VSource>(elements[idx])) {
-                    ctx.voltageByElement[idx] = ctx.voltageUnknowns++;
-                    ctx.voltageIndexToElement.push_back(idx);
-                }
+                std::visit(
+                    [&](const auto& component) {
+                        using T = std::decay_t<decltype(component)>;
+                        if constexpr (!std::is_same_v<T, Wire>) {
+                            ctx.terminals[idx] = {ctx.nodeEquationIndex(supernodeOf(component.a)),
+                                ctx.nodeEquationIndex(supernodeOf(component.b))};
+                        }
+                        if constexpr (std::is_same_v<T, VSource>) {
+                            ctx.voltageRowByElement[idx] = ctx.nodeUnknowns + ctx.voltageUnknowns++;
+                            ctx.voltageIndexToElement.push_back(idx);
+                        }
+                    },
+                    elements[idx]);
             }
 
             return ctx;
         }
 
-        double voltageAtNode(const MnaContext& ctx, unsigned int nodeId, const Eigen::VectorXd& solution) {
-            if (nodeId == ctx.groundId) {
-                return 0.0;
+        void hashCombine(std::size_t& seed, std::size_t value) {
+            seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+        }
+
+        // Element kind, then both supernode-resolved terminals (what buildMnaContext stamps), for every
+        // element in order.
+        template <typename Visitor>
+        void forEachTerminal(const std::vector<Element>& elements, const SupernodeMap& supernodeOf, Visitor&& visit) {
+            for (const auto& element : elements) {
+                std::visit(
+                    [&](const auto& component) {
+                        visit(element.index());
+                        visit(supernodeOf(component.a));
+                        visit(supernodeOf(component.b));
+                    },
+                    element);
+            }
+        }
+
+        std::size_t topologyHash(const std::vector<Node>& unitedNodes,
+            const std::vector<Element>& elements,
+            const SupernodeMap& supernodeOf) {
+            std::size_t seed = unitedNodes.size();
+            for (const auto& node : unitedNodes) {
+                hashCombine(seed, node.id);
+                hashCombine(seed, std::hash<std::string>{}(node.name));
+            }
+            hashCombine(seed, elements.size());
+            forEachTerminal(elements, supernodeOf, [&](std::size_t value) { hashCombine(seed, value); });
+            return seed;
+        }
+
+        TopologySignature topologySignature(const std::vector<Node>& unitedNodes,
+            const std::vector<Element>& elements,
+            const SupernodeMap& supernodeOf) {
+            TopologySignature signature;
+            signature.nodeIds.reserve(unitedNodes.size());
+            signature.nodeNames.reserve(unitedNodes.size());
+            for (const auto& node : unitedNodes) {
+                signature.nodeIds.push_back(node.id);
+                signature.nodeNames.push_back(node.name);
             }
-            const int idx = ctx.nodeEquationIndex(nodeId);
-            if (idx < 0 || idx >= solution.size()) {
-                return 0.0;
+            signature.terminals.reserve(elements.size() * 3);
+            forEachTerminal(elements, supernodeOf, [&](std::size_t value) { signature.terminals.push_back(value); });
+            return signature;
+        }
+
+        // Compares in place so a cache hit does not allocate.
+        bool matchesTopology(const TopologySignature& signature,
+            const std::vector<Node>& unitedNodes,
+            const std::vector<Element>& elements,
+            const SupernodeMap& supernodeOf) {
+            if (signature.nodeIds.size() != unitedNodes.size() || signature.terminals.size() != elements.size() * 3) {
+                return false;
             }
-            return solution(idx);
+            for (std::size_t i = 0; i < unitedNodes.size(); ++i) {
+                if (signature.nodeIds[i] != unitedNodes[i].id || signature.nodeNames[i] != unitedNodes[i].name) {
+                    return false;
+                }
+            }
+            std::size_t next = 0;
+            bool same = true;
+            forEachTerminal(elements, supernodeOf,
+                [&](std::size_t value) { same = same && signature.terminals[next++] == value; });
+            return same;
+        }
+
+        bool cacheHoldsTopology(const SolverCache& cache,
+            const std::vector<Node>& unitedNodes,
+            const std::vector<Element>& elements,
+            const SupernodeMap& supernodeOf) {
+            return cache.hasTopology
+                && cache.topologyHash == topologyHash(unitedNodes, elements, supernodeOf)
+                && matchesTopology(cache.topology, unitedNodes, elements, supernodeOf);
+        }
+
+        const MnaContext& cachedContext(SolverCache& cache,
+            const std::vector<Node>& unitedNodes,
+            const std::vector<Element>& elements,
+            const SupernodeMap& supernodeOf,
+            SolverStatistics& statistics) {
+            const std::size_t hash = topologyHash(unitedNodes, elements, supernodeOf);
+            statistics.reusedTopology = cache.hasTopology && cache.topologyHash == hash
+                && matchesTopology(cache.topology, unitedNodes, elements, supernodeOf);
+            if (!statistics.reusedTopology) {
+                cache.ctx = buildMnaContext(unitedNodes, elements, supernodeOf);
+                cache.topologyHash = hash;
+                cache.topology = topologySignature(unitedNodes, elements, supernodeOf);
+                cache.hasTopology = true;
+            }
+            return cache.ctx;
+        }
+
+        bool assignElementValue(Element& element, float value) {
+            return std::visit(
+                [&](auto& component) {
+                    using T = std::decay_t<decltype(component)>;
+                    if constexpr (std::is_same_v<T, Res>) {
+                        component.res = value;
+                    } else if constexpr (std::is_same_v<T, Cap>) {
+                        component.cap = value;
+                    } else if constexpr (std::is_same_v<T, VSource>) {
+                        component.vol = value;
+                    } else if constexpr (std::is_same_v<T, ISource>) {
+                        component.cur = value;
+                    } else {
+                        return false;
+                    }
+                    return true;
+                },
+                element);
+        }
+
+        // A^-1 rhs with whichever DC factorization solveLocked() left behind.
+        Eigen::MatrixXd solveWithDcFactorization(SolverCache& cache, const Eigen::MatrixXd& rhs) {
+            if (cache.dcUsesIterative) {
+                return cache.dcIterative.solveBlock(rhs);
+            }
+            return cache.dcUsesBlocks ? cache.dcBlocks.solveBlock(rhs) : cache.dcSolver.solveBlock(rhs);
+        }
+
+        // Whether the cached DC factorization was computed for exactly these values and options; the cache
+        // is shared with copies that may have solved other values since.
+        bool dcFactorizationCurrent(const SolverCache& cache,
+            const std::vector<Node>& united,
+            const std::vector<Element>& elements,
+            const SupernodeMap& supernodeOf,
+            const SolverOptions& options) {
+            std::vector<double> current;
+            defaultStampRegistry().coefficients(elements, current);
+            current.push_back(1.0);
+            return cacheHoldsTopology(cache, united, elements, supernodeOf)
+                && cache.program.isCompiled()
+                && cache.dcOptions == options
+                && cache.dcCoefficients == current;
+        }
+
+        // A^-T rhs with the DC factorization solveLocked() left behind; false if that factorization cannot
+        // be transposed (SparseQR of a singular matrix) or CG did not converge.
+        bool solveTransposedWithDcFactorization(SolverCache& cache, const Eigen::VectorXd& rhs, Eigen::VectorXd& x) {
+            if (cache.dcUsesIterative) {
+                // Only SPD systems go to CG, so A^T = A.
+                x = cache.dcIterative.solveDetached(rhs);
+                return cache.dcIterative.lastStatistics().converged;
+            }
+            if (cache.dcUsesBlocks) {
+                if (!cache.dcBlocks.canSolveTransposed()) {
+                    return false;
+                }
+                x = cache.dcBlocks.solveTransposed(rhs);
+                return true;
+            }
+            if (!cache.dcSolver.canSolveTransposed()) {
+                return false;
+            }
+            x = cache.dcSolver.solveTransposed(rhs);
+            return true;
+        }
+
+        // Positive resistors and capacitors plus current sources stamp a symmetric, diagonally dominant
+        // nodal matrix (also with the capacitor companion conductances added). It is positive definite
+        // unless a subcircuit floats, in which case the LDL^T attempt fails and LU takes over.
+        bool symmetricPositiveElements(const std::vector<Element>& elements) {
+            return std::ranges::all_of(elements, [](const Element& element) {
+                return std::visit(
+                    [](const auto& component) {
+                        using T = std::decay_t<decltype(component)>;
+                        if constexpr (std::is_same_v<T, Res>) {
+                            return component.res > 0.0f;
+                        } else if constexpr (std::is_same_v<T, Cap>) {
+                            return component.cap >= 0.0f;
+                        } else {
+                            return !std::is_same_v<T, VSource>;
+                        }
+                    },
+                    element);
+            });
+        }
+
+        // Result columns: node unknowns in solution order, then ground; wire-merged nodes alias their representative.
+        void buildNodeColumns(const MnaContext& ctx,
+            const std::vector<Node>& nodes,
+            const SupernodeMap& supernodeOf,
+            std::vector<unsigned int>& nodeIds,
+            std::unordered_map<unsigned int, std::size_t>& nodeIndex) {
+            nodeIds = ctx.indexToNodeId;
+            nodeIndex.clear();
+            for (std::size_t i = 0; i < nodeIds.size(); ++i) {
+                nodeIndex[nodeIds[i]] = i;
+            }
+            nodeIndex[ctx.groundId] = nodeIds.size();
+            nodeIds.push_back(ctx.groundId);
+
+            for (const auto& node : nodes) {
+                const unsigned int representative = supernodeOf(node.id);
+                if (representative == node.id) {
+                    continue;
+                }
+                if (auto it = nodeIndex.find(representative); it != nodeIndex.end()) {
+                    nodeIndex.emplace(node.id, it->second);
+                }
+            }
+        }
+
+        // Columns for the observed nodes, or buildNodeColumns() when none are given. rows holds each column's
+        // solution row (-1 for ground); false if an observed id is not in the circuit.
+        bool selectNodeColumns(const MnaContext& ctx,
+            const std::vector<Node>& nodes,
+            const SupernodeMap& supernodeOf,
+            const std::vector<unsigned int>& observed,
+            std::vector<unsigned int>& nodeIds,
+            std::unordered_map<unsigned int, std::size_t>& nodeIndex,
+            std::vector<int>& rows) {
+            std::vector<unsigned int> allIds;
+            std::unordered_map<unsigned int, std::size_t> allIndex;
+            buildNodeColumns(ctx, nodes, supernodeOf, allIds, allIndex);
+            const std::size_t groundColumn = allIds.size() - 1;
+            rows.clear();
+            if (observed.empty()) {
+                for (std::size_t column = 0; column < allIds.size(); ++column) {
+                    rows.push_back(column == groundColumn ? -1 : static_cast<int>(column));
+                }
+                nodeIds = std::move(allIds);
+                nodeIndex = std::move(allIndex);
+                return true;
+            }
+            nodeIds.clear();
+            nodeIndex.clear();
+            for (unsigned int id : observed) {
+                const auto it = allIndex.find(id);
+                if (it == allIndex.end()) {
+                    return false;
+                }
+                nodeIndex.emplace(id, nodeIds.size());
+                nodeIds.push_back(id);
+                rows.push_back(it->second == groundColumn ? -1 : static_cast<int>(it->second));
+            }
+            return true;
         }
 
         nlohmann::json serializeElement(const Element& element) {
@@ -158,6 +422,9 @@ namespace circuitx {
         }
     } // namespace
 
+    Circuit::Circuit()
+        : solverCache(std::make_shared<SolverCache>()) {}
+
     nlohmann::json Circuit::toJson() const {
         nlohmann::json nodesJson = nlohmann::json::array();
         for (const auto& node : nodes) {
@@ -173,11 +440,9 @@ namespace circuitx {
     }
 
     Eigen::VectorXd Circuit::getVector() {
-        if (united.empty()) {
-            unify();
-        }
+        unify();
 
-        const MnaContext ctx = buildMnaContext(united, elements);
+        const MnaContext ctx = buildMnaContext(united, elements, supernodeResolver());
         cacheSolutionOrdering(ctx.indexToNodeId, ctx.voltageIndexToElement, ctx.groundId);
         const int totalSize = ctx.systemSize();
 
@@ -186,34 +451,121 @@ namespace circuitx {
             return rhs;
         }
 
-        ElementStampContext context(ctx, nullptr, &rhs);
+        ElementStampContext context(ctx, static_cast<Eigen::MatrixXd*>(nullptr), &rhs);
         defaultStampRegistry().stamp(elements, context);
         return rhs;
     }
 
     Eigen::VectorXd Circuit::solve() {
         unify();
-        const MnaContext ctx = buildMnaContext(united, elements);
+        std::lock_guard lock(solverCache->mutex);
+        return solveLocked();
+    }
+
+    Eigen::VectorXd Circuit::solveLocked() {
+        statistics = SolverStatistics{};
+        const MnaContext& ctx = cachedContext(*solverCache, united, elements, supernodeResolver(), statistics);
         cacheSolutionOrdering(ctx.indexToNodeId, ctx.voltageIndexToElement, ctx.groundId);
-        Eigen::MatrixXd A = Eigen::MatrixXd::Zero(ctx.systemSize(), ctx.systemSize());
-        Eigen::VectorXd z = Eigen::VectorXd::Zero(ctx.systemSize());
+        const int systemSize = ctx.systemSize();
+        Eigen::VectorXd z = Eigen::VectorXd::Zero(systemSize);
+        statistics.systemSize = static_cast<std::size_t>(systemSize);
 
-        if (ctx.systemSize() == 0) {
+        if (systemSize == 0) {
             return z;
         }
 
-        ElementStampContext context(ctx, &A, &z);
-        defaultStampRegistry().stamp(elements, context);
+        LinearSolver& solver = solverCache->dcSolver;
+        StampProgram& program = solverCache->program;
+        solver.setFactorization(solverOptions.factorization);
+        solver.setOrdering(solverOptions.ordering);
+        const std::size_t analysesBefore = solver.symbolicAnalyses();
+        statistics.sparse = useSparseBackend(solverOptions, systemSize);
+        const bool recompile = !statistics.reusedTopology || !program.isCompiled() || program.isSparse() != statistics.sparse;
+        if (recompile) {
+            program.compile(ctx, elements, statistics.sparse);
+        } else {
+            program.refresh(elements);
+        }
+        solverCache->dcCoefficients = program.elementCoefficients();
+        solverCache->dcOptions = solverOptions;
+
+        solverCache->dcUsesIterative = false;
+        if (solverOptions.backend == MatrixBackend::Iterative && symmetricPositiveElements(elements)) {
+            // CG over the whole system: independent subcircuits are just a block-diagonal SPD matrix to it.
+            ConjugateGradientSolver& iterative = solverCache->dcIterative;
+            iterative.configure(solverOptions.iterative);
+            const std::size_t iterativeAnalysesBefore = iterative.symbolicAnalyses();
+            program.assemble(solverCache->dcSparse, z);
+            iterative.setup(solverCache->dcSparse);
+            Eigen::VectorXd x = iterative.solve(z);
+            const ConjugateGradientSolver::Statistics& cg = iterative.lastStatistics();
+            statistics.iterative = true;
+            statistics.iterations = cg.iterations;
+            statistics.residual = cg.residual;
+            statistics.converged = cg.converged;
+            statistics.symmetric = true;
+            statistics.matrixNonZeros = static_cast<std::size_t>(solverCache->dcSparse.nonZeros());
+            if (cg.converged) {
+                statistics.reusedSymbolic = iterative.symbolicAnalyses() == iterativeAnalysesBefore;
+                solverCache->dcUsesBlocks = false;
+                solverCache->dcUsesIterative = true;
+                return x;
+            }
+            // No convergence within maxIterations (e.g. a floating subcircuit makes A singular): solve directly.
+        }
 
-        return A.colPivHouseholderQr().solve(z);
+        BlockSolver& blocks = solverCache->dcBlocks;
+        if (solverOptions.decomposeBlocks
+            && (recompile || !blocks.isConfigured() || solverCache->blockOptions != solverOptions)) {
+            blocks.configure(program, solverOptions);
+            solverCache->blockOptions = solverOptions;
+        }
+        solverCache->dcUsesBlocks = solverOptions.decomposeBlocks && blocks.blockCount() > 1;
+        const bool symmetric = solverOptions.useCholesky && symmetricPositiveElements(elements);
+        solver.setSymmetricPositiveDefinite(symmetric);
+        blocks.setSymmetricPositiveDefinite(symmetric);
+
+        if (solverCache->dcUsesBlocks) {
+            // Independent subcircuits: assemble once, then factor and solve each block on its own.
+            const std::size_t blockAnalysesBefore = blocks.symbolicAnalyses();
+            if (statistics.sparse) {
+                program.assemble(solverCache->dcSparse, z);
+                blocks.factorize(solverCache->dcSparse.valuePtr());
+            } else {
+                program.assemble(solverCache->dcDense, z);
+                blocks.factorize(solverCache->dcDense.data());
+            }
+            statistics.blocks = blocks.blockCount();
+            statistics.reusedSymbolic = blocks.symbolicAnalyses() == blockAnalysesBefore;
+            statistics.symmetric = blocks.isSymmetric();
+            if (statistics.sparse) {
+                statistics.ordering = blocks.ordering();
+                statistics.matrixNonZeros = static_cast<std::size_t>(solverCache->dcSparse.nonZeros());
+                statistics.factorNonZeros = blocks.factorNonZeros();
+            }
+            return blocks.solve(z);
+        }
+
+        if (statistics.sparse) {
+            program.assemble(solverCache->dcSparse, z);
+            solver.factorize(solverCache->dcSparse);
+            statistics.reusedSymbolic = solver.symbolicAnalyses() == analysesBefore;
+            statistics.ordering = solver.ordering();
+            statistics.matrixNonZeros = static_cast<std::size_t>(solverCache->dcSparse.nonZeros());
+            statistics.factorNonZeros = solver.factorNonZeros();
+        } else {
+            program.assemble(solverCache->dcDense, z);
+            solver.factorize(solverCache->dcDense);
+        }
+        statistics.symmetric = solver.isSymmetric();
+
+        return solver.solve(z);
     }
 
     Eigen::MatrixXd Circuit::getMatrix() {
-        if (united.empty()) {
-            unify();
-        }
+        unify();
 
-        const MnaContext ctx = buildMnaContext(united, elements);
+        const MnaContext ctx = buildMnaContext(united, elements, supernodeResolver());
         cacheSolutionOrdering(ctx.indexToNodeId, ctx.voltageIndexToElement, ctx.groundId);
         const int totalSize = ctx.systemSize();
 
@@ -227,88 +579,135 @@ namespace circuitx {
         return A;
     }
 
-    void Circuit::unify() {
-        united.clear();
-        if (nodes.empty()) {
+    void Circuit::addNode(const Node& n) {
+        nodes.push_back(n);
+        if (supernodesDirty) {
             return;
         }
-
-        std::unordered_map<unsigned int, std::size_t> idToIndex;
-        idToIndex.reserve(nodes.size());
-        for (std::size_t i = 0; i < nodes.size(); ++i) {
-            idToIndex[nodes[i].id] = i;
+        if (!nodeSlots.emplace(n.id, nodes.size() - 1).second) {
+            supernodesDirty = true; // duplicate ID, let the full rebuild sort out which entry wins
+            return;
         }
+        supernodeParent.push_back(nodes.size() - 1);
+        unitedDirty = true;
+    }
 
-        std::vector<std::size_t> parent(nodes.size());
-        for (std::size_t i = 0; i < nodes.size(); ++i) {
-            parent[i] = i;
+    void Circuit::addElement(const Element& e) {
+        elements.push_back(e);
+        if (const auto* wire = std::get_if<Wire>(&e); wire && !supernodesDirty) {
+            uniteNodes(wire->a, wire->b);
         }
+    }
 
-        auto findSet = [&](std::size_t idx) {
-            std::size_t root = idx;
-            while (parent[root] != root) {
-                root = parent[root];
+    std::size_t Circuit::removeElementsIf(const std::function<bool(const Element&)>& predicate) {
+        bool removedWire = false;
+        const auto newEnd = std::remove_if(elements.begin(), elements.end(), [&](const Element& element) {
+            if (!predicate(element)) {
+                return false;
             }
-            while (idx != root) {
-                std::size_t next = parent[idx];
-                parent[idx] = root;
-                idx = next;
-            }
-            return root;
-        };
+            removedWire = removedWire || std::holds_alternative<Wire>(element);
+            return true;
+        });
+        const auto removed = static_cast<std::size_t>(std::distance(newEnd, elements.end()));
+        elements.erase(newEnd, elements.end());
+        // Union-find cannot split a set, so losing a wire means rebuilding on the next solve.
+        if (removedWire) {
+            supernodesDirty = true;
+        }
+        return removed;
+    }
+
+    void Circuit::removeNode(unsigned int nodeId) {
+        nodes.erase(std::remove_if(nodes.begin(), nodes.end(), [&](const Node& node) { return node.id == nodeId; }),
+            nodes.end());
+        supernodesDirty = true;
+    }
+
+    bool Circuit::setElementValue(std::size_t index, float value) {
+        if (index >= elements.size()) {
+            return false;
+        }
+        return assignElementValue(elements[index], value);
+    }
+
+    std::function<unsigned int(unsigned int)> Circuit::supernodeResolver() {
+        return [this](unsigned int id) { return supernodeOf(id); };
+    }
+
+    unsigned int Circuit::supernodeOf(unsigned int nodeId) {
+        unify();
+        auto it = nodeSlots.find(nodeId);
+        if (it == nodeSlots.end()) {
+            return nodeId;
+        }
+        return nodes[findSupernode(it->second)].id;
+    }
 
-        auto uniteSets = [&](std::size_t a, std::size_t b) {
-            std::size_t rootA = findSet(a);
-            std::size_t rootB = findSet(b);
-            if (rootA == rootB) {
-                return;
+    std::size_t Circuit::findSupernode(std::size_t slot) {
+        while (supernodeParent[slot] != slot) {
+            supernodeParent[slot] = supernodeParent[supernodeParent[slot]];
+            slot = supernodeParent[slot];
+        }
+        return slot;
+    }
+
+    void Circuit::uniteNodes(unsigned int a, unsigned int b) {
+        auto itA = nodeSlots.find(a);
+        auto itB = nodeSlots.find(b);
+        if (itA == nodeSlots.end() || itB == nodeSlots.end()) {
+            return;
+        }
+        std::size_t rootA = findSupernode(itA->second);
+        std::size_t rootB = findSupernode(itB->second);
+        if (rootA == rootB) {
+            return;
+        }
+        // The lowest node ID represents the supernode.
+        if (nodes[rootB].id < nodes[rootA].id) {
+            std::swap(rootA, rootB);
+        }
+        supernodeParent[rootB] = rootA;
+        unitedDirty = true;
+    }
+
+    void Circuit::unify() {
+        if (supernodesDirty) {
+            nodeSlots.clear();
+            nodeSlots.reserve(nodes.size());
+            for (std::size_t i = 0; i < nodes.size(); ++i) {
+                nodeSlots[nodes[i].id] = i;
             }
-            if (nodes[rootB].id < nodes[rootA].id) {
-                std::swap(rootA, rootB);
+            supernodeParent.resize(nodes.size());
+            for (std::size_t i = 0; i < nodes.size(); ++i) {
+                supernodeParent[i] = i;
             }
-            parent[rootB] = rootA;
-        };
-
-        for (const auto& element : elements) {
-            if (const auto* wire = std::get_if<Wire>(&element)) {
-                auto itA = idToIndex.find(wire->a);
-                auto itB = idToIndex.find(wire->b);
-                if (itA == idToIndex.end() || itB == idToIndex.end()) {
-                    continue;
+            // Duplicate IDs keep the last entry, like the map above; earlier duplicates follow it.
+            for (std::size_t i = 0; i < nodes.size(); ++i) {
+                supernodeParent[i] = nodeSlots[nodes[i].id];
+            }
+            supernodesDirty = false;
+            for (const auto& element : elements) {
+                if (const auto* wire = std::get_if<Wire>(&element)) {
+                    uniteNodes(wire->a, wire->b);
                 }
-                uniteSets(itA->second, itB->second);
             }
+            unitedDirty = true;
         }
 
-        auto remapNodeId = [&](unsigned int nodeId) {
-            auto it = idToIndex.find(nodeId);
-            if (it == idToIndex.end()) {
-                return nodeId;
-            }
-            auto root = findSet(it->second);
-            return nodes[root].id;
-        };
-
-        for (auto& element : elements) {
-            std::visit(
-                [&](auto& component) {
-                    using T = std::decay_t<decltype(component)>;
-                    if constexpr (!std::is_same_v<T, Wire>) {
-                        component.a = remapNodeId(component.a);
-                        component.b = remapNodeId(component.b);
-                    }
-                },
-                element);
+        if (!unitedDirty) {
+            return;
         }
 
+        united.clear();
         std::vector<bool> added(nodes.size(), false);
         for (std::size_t idx = 0; idx < nodes.size(); ++idx) {
-            auto root = findSet(idx);
+            auto root = findSupernode(idx);
             if (!added[root]) {
                 united.push_back(nodes[root]);
                 added[root] = true;
             }
         }
+        unitedDirty = false;
     }
 
     void Circuit::cacheSolutionOrdering(const std::vector<unsigned int>& nodesInSolution,
@@ -319,115 +718,573 @@ namespace circuitx {
         solutionGroundId = groundId;
     }
 
-    TransientResult Circuit::simulateTransient(double durationSeconds, double timestepSeconds) {
-        TransientResult result;
-        if (durationSeconds <= 0.0 || timestepSeconds <= 0.0) {
+    DcSweepResult Circuit::sweepDc(const DcSweep& sweep) {
+        DcSweepResult result;
+        if (sweep.elementIndex >= elements.size() || sweep.values.empty()
+            || std::holds_alternative<Wire>(elements[sweep.elementIndex])) {
             return result;
         }
 
         unify();
-        const MnaContext ctx = buildMnaContext(united, elements);
-        cacheSolutionOrdering(ctx.indexToNodeId, ctx.voltageIndexToElement, ctx.groundId);
+        std::lock_guard lock(solverCache->mutex);
+        // Compiles/refreshes the program and leaves dcSolver factored for the current values.
+        solveLocked();
+        const MnaContext& ctx = solverCache->ctx;
+        const int systemSize = ctx.systemSize();
+        if (systemSize == 0) {
+            return result;
+        }
+
+        StampProgram& program = solverCache->program;
+        LinearSolver& solver = solverCache->dcSolver;
+        const std::size_t element = sweep.elementIndex;
+        const std::size_t points = sweep.values.size();
+
+        std::vector<double> coefficients(points);
+        Element swept = elements[element];
+        for (std::size_t k = 0; k < points; ++k) {
+            assignElementValue(swept, static_cast<float>(sweep.values[k]));
+            coefficients[k] = DefaultStampRegistry::coefficient(swept);
+        }
 
+        Eigen::MatrixXd solutions(systemSize, static_cast<Eigen::Index>(points));
+        if (!program.scalesMatrix(element)) {
+            // Sources only enter the right-hand side: move the base RHS by the coefficient delta and
+            // solve every sweep point against the factorization solve() just produced.
+            const double current = program.elementCoefficients()[element];
+            Eigen::VectorXd baseZ;
+            program.assembleRhs(baseZ);
+            Eigen::MatrixXd block(systemSize, static_cast<Eigen::Index>(points));
+            for (std::size_t k = 0; k < points; ++k) {
+                Eigen::VectorXd column = baseZ;
+                program.accumulateRhs(element, coefficients[k] - current, column);
+                block.col(static_cast<Eigen::Index>(k)) = column;
+            }
+            solutions = solveWithDcFactorization(*solverCache, block);
+        } else {
+            // The matrix changes per point; the pattern does not, so only the numeric factorization is redone.
+            const double original = program.elementCoefficients()[element];
+            Eigen::VectorXd z;
+            for (std::size_t k = 0; k < points; ++k) {
+                program.setCoefficient(element, coefficients[k]);
+                if (solverCache->dcUsesIterative) {
+                    // Each point starts CG from the previous point's solution.
+                    program.assemble(solverCache->dcSparse, z);
+                    ConjugateGradientSolver& iterative = solverCache->dcIterative;
+                    iterative.setup(solverCache->dcSparse);
+                    Eigen::VectorXd x = iterative.solve(z);
+                    if (!iterative.lastStatistics().converged) {
+                        solver.factorize(solverCache->dcSparse);
+                        x = solver.solve(z);
+                    }
+                    solutions.col(static_cast<Eigen::Index>(k)) = x;
+                    continue;
+                }
+                if (program.isSparse()) {
+                    program.assemble(solverCache->dcSparse, z);
+                    solver.factorize(solverCache->dcSparse);
+                } else {
+                    program.assemble(solverCache->dcDense, z);
+                    solver.factorize(solverCache->dcDense);
+                }
+                solutions.col(static_cast<Eigen::Index>(k)) = solver.solve(z);
+            }
+            program.setCoefficient(element, original);
+            // The DC factorization now holds the last sweep point, not the circuit's values.
+            solverCache->dcCoefficients.clear();
+        }
+
+        result.solved = true;
+        result.elementIndex = element;
+        result.referenceNodeId = ctx.groundId;
+        result.sweepValues = sweep.values;
+        buildNodeColumns(ctx, nodes, supernodeResolver(), result.nodeIds, result.nodeIndex);
+
+        // Node rows of the solution block become contiguous per-node columns; ground stays zero.
+        const std::size_t nodeUnknowns = result.nodeIds.size() - 1;
+        result.voltages.assign(result.nodeIds.size() * points, 0.0);
+        for (std::size_t node = 0; node < nodeUnknowns; ++node) {
+            double* column = result.voltages.data() + node * points;
+            for (std::size_t k = 0; k < points; ++k) {
+                column[k] = solutions(static_cast<Eigen::Index>(node), static_cast<Eigen::Index>(k));
+            }
+        }
+        return result;
+    }
+
+    WhatIfResult Circuit::solveWhatIf(std::span<const ValueChange> changes, const WhatIfOptions& options) {
+        WhatIfResult result;
+        unify();
+        std::lock_guard lock(solverCache->mutex);
+
+        if (!dcFactorizationCurrent(*solverCache, united, elements, supernodeResolver(), solverOptions)) {
+            solveLocked();
+        }
+        const MnaContext& ctx = solverCache->ctx;
+        cacheSolutionOrdering(ctx.indexToNodeId, ctx.voltageIndexToElement, ctx.groundId);
         const int systemSize = ctx.systemSize();
+
+        // Later changes of the same element win.
+        std::vector<std::pair<std::size_t, double>> changed;
+        for (const auto& change : changes) {
+            if (change.elementIndex >= elements.size() || std::holds_alternative<Wire>(elements[change.elementIndex])) {
+                return result;
+            }
+            Element element = elements[change.elementIndex];
+            assignElementValue(element, static_cast<float>(change.value));
+            const double coefficient = DefaultStampRegistry::coefficient(element);
+            auto it = std::find_if(changed.begin(), changed.end(),
+                [&](const auto& entry) { return entry.first == change.elementIndex; });
+            if (it != changed.end()) {
+                it->second = coefficient;
+            } else {
+                changed.emplace_back(change.elementIndex, coefficient);
+            }
+        }
         if (systemSize == 0) {
+            result.solved = true;
+            result.solution = Eigen::VectorXd::Zero(0);
             return result;
         }
 
-        Eigen::MatrixXd baseA = Eigen::MatrixXd::Zero(systemSize, systemSize);
-        Eigen::VectorXd baseZ = Eigen::VectorXd::Zero(systemSize);
-        std::vector<CapacitorState> capacitors;
+        StampProgram& program = solverCache->program;
+        const std::vector<double>& base = program.elementCoefficients();
+        Eigen::VectorXd rhs;
+        program.assembleRhs(rhs);
+        std::vector<RankOneUpdate> updates;
+        bool rankOne = true;
+        for (const auto& [element, coefficient] : changed) {
+            const double delta = coefficient - base[element];
+            if (delta == 0.0) {
+                continue;
+            }
+            program.accumulateRhs(element, delta, rhs);
+            const StampProgram::RankOneStamp& stamp = program.rankOneStamp(element);
+            if (stamp.valid) {
+                updates.push_back({stamp, delta});
+            } else if (program.scalesMatrix(element)) {
+                rankOne = false;
+            }
+        }
+        result.rank = updates.size();
+
+        if (!solverCache->dcUsesIterative && rankOne && updates.size() <= options.maxRank) {
+            const Eigen::MatrixXd solved = solveWithDcFactorization(*solverCache, woodburyRhs(rhs, updates));
+            if (woodburySolution(solved, updates, result.solution)) {
+                result.solved = true;
+                result.method = WhatIfMethod::LowRank;
+                return result;
+            }
+        }
+
+        // Assemble the changed system from a coefficient copy; the program keeps the circuit's values.
+        std::vector<double> coefficients = base;
+        for (const auto& [element, coefficient] : changed) {
+            coefficients[element] = coefficient;
+        }
+        if (solverCache->dcUsesIterative) {
+            program.assemble(solverCache->whatIfSparse, rhs, coefficients);
+            ConjugateGradientSolver& iterative = solverCache->dcIterative;
+            result.solution = iterative.solve(solverCache->whatIfSparse, rhs);
+            if (iterative.lastStatistics().converged) {
+                result.solved = true;
+                result.method = WhatIfMethod::Iterative;
+                return result;
+            }
+        }
 
-        ElementStampContext baseContext(ctx, &baseA, &baseZ, &capacitors);
-        defaultStampRegistry().stamp(elements, baseContext);
+        LinearSolver& scratch = solverCache->whatIfSolver;
+        scratch.setFactorization(solverOptions.factorization);
+        scratch.setOrdering(solverOptions.ordering);
+        scratch.setSymmetricPositiveDefinite(solverOptions.useCholesky && symmetricPositiveElements(elements));
+        bool factored = false;
+        if (program.isSparse()) {
+            program.assemble(solverCache->whatIfSparse, rhs, coefficients);
+            factored = scratch.factorize(solverCache->whatIfSparse);
+        } else {
+            program.assemble(solverCache->whatIfDense, rhs, coefficients);
+            factored = scratch.factorize(solverCache->whatIfDense);
+        }
+        result.method = WhatIfMethod::Refactored;
+        if (factored) {
+            result.solution = scratch.solve(rhs);
+            result.solved = result.solution.allFinite();
+        }
+        return result;
+    }
 
-        Eigen::VectorXd steadyState = solve();
+    MonteCarloResult Circuit::runMonteCarlo(const MonteCarloOptions& options) {
+        MonteCarloResult result;
+        if (options.trials == 0) {
+            return result;
+        }
 
-        auto initialVoltageAt = [&](unsigned int nodeId) {
-            return voltageAtNode(ctx, nodeId, steadyState);
-        };
+        unify();
+        std::lock_guard lock(solverCache->mutex);
+        // Compiles/refreshes the program; every trial then only swaps coefficients.
+        solveLocked();
+        const MnaContext& ctx = solverCache->ctx;
+        if (ctx.systemSize() == 0) {
+            return result;
+        }
 
-        for (auto& cap : capacitors) {
-            cap.prevVoltage = initialVoltageAt(cap.a) - initialVoltageAt(cap.b);
+        std::vector<ToleranceTarget> targets;
+        for (std::size_t idx = 0; idx < elements.size(); ++idx) {
+            if (const auto* res = std::get_if<Res>(&elements[idx]); res && res->res > 0.0f) {
+                targets.push_back({idx, options.resistorTolerance, true});
+            }
         }
 
-        const int totalSteps = static_cast<int>(std::ceil(durationSeconds / timestepSeconds));
+        MonteCarloOutcome outcome = circuitx::runMonteCarlo(solverCache->program, targets, options, solverOptions,
+            solverOptions.useCholesky && symmetricPositiveElements(elements), ctx.indexToNodeId.size());
+
         result.solved = true;
-        result.timestep = timestepSeconds;
+        result.trials = options.trials;
+        result.failedTrials = outcome.failedTrials;
         result.referenceNodeId = ctx.groundId;
-        result.nodeIds = ctx.indexToNodeId;
-        result.nodeVoltages.clear();
-        result.nodeVoltages.resize(result.nodeIds.size());
-        for (std::size_t i = 0; i < result.nodeIds.size(); ++i) {
-            result.nodeIndex[result.nodeIds[i]] = i;
-            result.nodeVoltages[i].reserve(static_cast<std::size_t>(totalSteps) + 1);
-        }
-        // Append ground reference
-        result.nodeIndex[result.referenceNodeId] = result.nodeIds.size();
-        result.nodeIds.push_back(result.referenceNodeId);
-        result.nodeVoltages.emplace_back();
-        result.nodeVoltages.back().reserve(static_cast<std::size_t>(totalSteps) + 1);
-
-        auto recordSample = [&](const Eigen::VectorXd& solution, double time) {
-            result.times.push_back(time);
-            for (std::size_t i = 0; i < ctx.indexToNodeId.size(); ++i) {
-                const unsigned int nodeId = ctx.indexToNodeId[i];
-                const double voltage = voltageAtNode(ctx, nodeId, solution);
-                result.nodeVoltages[i].push_back(voltage);
-            }
-            // ground
-            auto groundIdx = result.nodeIndex[result.referenceNodeId];
-            if (groundIdx < result.nodeVoltages.size()) {
-                result.nodeVoltages[groundIdx].push_back(0.0);
-            }
-        };
-
-        recordSample(steadyState, 0.0);
-
-        Eigen::MatrixXd A = Eigen::MatrixXd::Zero(systemSize, systemSize);
-        Eigen::VectorXd z = Eigen::VectorXd::Zero(systemSize);
+        buildNodeColumns(ctx, nodes, supernodeResolver(), result.nodeIds, result.nodeIndex);
+        result.nodes = std::move(outcome.nodes);
+        NodeStatistics ground;
+        ground.histogram.assign(std::max<std::size_t>(options.histogramBins, 1), 0);
+        ground.histogram.front() = options.trials - result.failedTrials;
+        result.nodes.push_back(std::move(ground));
+        return result;
+    }
 
-        Eigen::VectorXd currentSolution = steadyState;
+    FaultResult Circuit::simulateFaults(const FaultOptions& options) {
+        FaultResult result;
+        if (!(options.openResistance > 0.0) || !(options.shortResistance > 0.0)) {
+            return result;
+        }
 
-        for (int step = 1; step <= totalSteps; ++step) {
-            A = baseA;
-            z = baseZ;
+        unify();
+        std::lock_guard lock(solverCache->mutex);
+        FaultBase base;
+        base.solution = solveLocked();
+        const MnaContext& ctx = solverCache->ctx;
+        const int systemSize = ctx.systemSize();
+        if (systemSize == 0) {
+            return result;
+        }
 
-            for (auto& cap : capacitors) {
-                if (cap.capacitance <= 0.0) {
-                    continue;
+        std::vector<int> observedRows;
+        if (!selectNodeColumns(ctx, nodes, supernodeResolver(), options.observedNodes,
+                result.nodeIds, result.nodeIndex, observedRows)) {
+            return result;
+        }
+
+        // Blocks fan out onto their own threads and CG keeps warm-start state, so the workers share one
+        // whole-system factorization instead.
+        const StampProgram& program = solverCache->program;
+        LinearSolver& solver = solverCache->dcSolver;
+        base.symmetric = solverOptions.useCholesky && symmetricPositiveElements(elements);
+        if (solverCache->dcUsesBlocks || solverCache->dcUsesIterative) {
+            solver.setSymmetricPositiveDefinite(base.symmetric);
+            if (program.isSparse()) {
+                solver.factorize(solverCache->dcSparse);
+            } else {
+                solver.factorize(solverCache->dcDense);
+            }
+        }
+        base.solver = &solver;
+        if (program.isSparse()) {
+            base.sparse = &solverCache->dcSparse;
+        } else {
+            base.dense = &solverCache->dcDense;
+        }
+        program.assembleRhs(base.rhs);
+        base.options = solverOptions;
+
+        // A fault replaces the element by a resistance across its terminals; capacitors are already open at DC.
+        const double openConductance = 1.0 / options.openResistance;
+        const double shortConductance = 1.0 / options.shortResistance;
+        std::vector<FaultTarget> targets;
+        for (std::size_t idx = 0; idx < elements.size(); ++idx) {
+            const bool resistor = std::holds_alternative<Res>(elements[idx]);
+            if (!resistor && !std::holds_alternative<Cap>(elements[idx])) {
+                continue;
+            }
+            FaultTarget target;
+            target.element = idx;
+            const auto [a, b] = ctx.terminals[idx];
+            if (a != b) {
+                for (const auto& [row, weight] : {std::pair{a, 1.0}, std::pair{b, -1.0}}) {
+                    if (row >= 0) {
+                        target.u.index[target.u.count] = row;
+                        target.u.weight[target.u.count] = weight;
+                        ++target.u.count;
+                    }
                 }
-                const double geq = cap.capacitance / timestepSeconds;
-                const double historyCurrent = geq * cap.prevVoltage;
+            }
+            target.u.valid = target.u.count > 0;
+            const double conductance = resistor ? program.elementCoefficients()[idx] : 0.0;
+            target.openDelta = resistor ? openConductance - conductance : 0.0;
+            target.shortDelta = shortConductance - conductance;
+            targets.push_back(target);
+        }
+
+        FaultOutcome outcome = runFaultSimulation(base, targets, observedRows, result.nodeIds, options);
+        result.solved = true;
+        result.referenceNodeId = ctx.groundId;
+        result.faults = std::move(outcome.faults);
+        result.deltas = std::move(outcome.deltas);
+        result.detectedFaults = static_cast<std::size_t>(std::count_if(result.faults.begin(), result.faults.end(),
+            [](const FaultReport& fault) { return fault.detected; }));
+        return result;
+    }
 
-                const int aIdx = ctx.nodeEquationIndex(cap.a);
-                const int bIdx = ctx.nodeEquationIndex(cap.b);
+    SensitivityResult Circuit::analyzeSensitivity(const SensitivityOptions& options) {
+        SensitivityResult result;
+        unify();
+        std::lock_guard lock(solverCache->mutex);
+        const bool reuse = dcFactorizationCurrent(*solverCache, united, elements, supernodeResolver(), solverOptions);
+        Eigen::VectorXd solution = reuse ? Eigen::VectorXd() : solveLocked();
+        const MnaContext& ctx = solverCache->ctx;
+        cacheSolutionOrdering(ctx.indexToNodeId, ctx.voltageIndexToElement, ctx.groundId);
+        const int systemSize = ctx.systemSize();
+        if (systemSize == 0) {
+            return result;
+        }
+        const StampProgram& program = solverCache->program;
+        if (reuse) {
+            Eigen::VectorXd rhs;
+            program.assembleRhs(rhs);
+            solution = solveWithDcFactorization(*solverCache, rhs);
+        }
 
-                if (aIdx >= 0) {
-                    A(aIdx, aIdx) += geq;
-                    z(aIdx) -= historyCurrent;
-                }
-                if (bIdx >= 0) {
-                    A(bIdx, bIdx) += geq;
-                    z(bIdx) += historyCurrent;
-                }
-                if (aIdx >= 0 && bIdx >= 0) {
-                    A(aIdx, bIdx) -= geq;
-                    A(bIdx, aIdx) -= geq;
+        std::vector<unsigned int> ids;
+        std::unordered_map<unsigned int, std::size_t> index;
+        buildNodeColumns(ctx, nodes, supernodeResolver(), ids, index);
+        const unsigned int referenceId = options.referenceNodeId.value_or(ctx.groundId);
+        const auto output = index.find(options.outputNodeId);
+        const auto reference = index.find(referenceId);
+        if (output == index.end() || reference == index.end()) {
+            return result;
+        }
+        const auto rowOf = [&](std::size_t column) { return column + 1 == ids.size() ? -1 : static_cast<int>(column); };
+        const int outputRow = rowOf(output->second);
+        const int referenceRow = rowOf(reference->second);
+
+        // The output is c^T x; one solve A^T lambda = c turns it into d output / d p = lambda^T (db/dp - dA/dp x).
+        Eigen::VectorXd selector = Eigen::VectorXd::Zero(systemSize);
+        if (outputRow >= 0) {
+            selector(outputRow) += 1.0;
+        }
+        if (referenceRow >= 0) {
+            selector(referenceRow) -= 1.0;
+        }
+        Eigen::VectorXd adjoint;
+        if (!solveTransposedWithDcFactorization(*solverCache, selector, adjoint)) {
+            // Singular systems (least-squares QR) and unconverged CG: factor the transpose itself.
+            LinearSolver& scratch = solverCache->whatIfSolver;
+            scratch.setFactorization(solverOptions.factorization);
+            scratch.setOrdering(solverOptions.ordering);
+            scratch.setSymmetricPositiveDefinite(false);
+            bool factored = false;
+            if (program.isSparse()) {
+                solverCache->whatIfSparse = solverCache->dcSparse.transpose();
+                factored = scratch.factorize(solverCache->whatIfSparse);
+            } else {
+                solverCache->whatIfDense = solverCache->dcDense.transpose();
+                factored = scratch.factorize(solverCache->whatIfDense);
+            }
+            if (!factored) {
+                return result;
+            }
+            adjoint = scratch.solve(selector);
+        }
+        if (!adjoint.allFinite() || !solution.allFinite()) {
+            return result;
+        }
+
+        std::vector<double> gradient;
+        program.coefficientGradient(adjoint, solution, gradient);
+        const std::vector<double>& coefficients = program.elementCoefficients();
+        for (std::size_t idx = 0; idx < elements.size(); ++idx) {
+            ElementSensitivity entry;
+            entry.elementIndex = idx;
+            if (const auto* res = std::get_if<Res>(&elements[idx])) {
+                if (!(res->res > 0.0f)) {
+                    continue;
                 }
+                // The stamp coefficient is g = 1/R, so d/dR = -g^2 d/dg.
+                entry.value = static_cast<double>(res->res);
+                entry.derivative = -coefficients[idx] * coefficients[idx] * gradient[idx];
+            } else if (std::holds_alternative<VSource>(elements[idx]) || std::holds_alternative<ISource>(elements[idx])) {
+                entry.value = coefficients[idx];
+                entry.derivative = gradient[idx];
+            } else {
+                continue;
+            }
+            entry.normalized = entry.value * entry.derivative;
+            result.elements.push_back(entry);
+        }
+        std::stable_sort(result.elements.begin(), result.elements.end(),
+            [](const ElementSensitivity& lhs, const ElementSensitivity& rhs) {
+                return std::abs(lhs.normalized) > std::abs(rhs.normalized);
+            });
+
+        result.solved = true;
+        result.outputNodeId = options.outputNodeId;
+        result.referenceNodeId = referenceId;
+        result.output = (outputRow >= 0 ? solution(outputRow) : 0.0) - (referenceRow >= 0 ? solution(referenceRow) : 0.0);
+        return result;
+    }
+
+    AcResult Circuit::analyzeAc(const AcOptions& options) {
+        AcResult result;
+        result.frequencies = acFrequencies(options);
+        if (result.frequencies.empty()) {
+            return result;
+        }
+        if (options.sourceElement) {
+            const std::size_t source = *options.sourceElement;
+            if (source >= elements.size()
+                || !(std::holds_alternative<VSource>(elements[source]) || std::holds_alternative<ISource>(elements[source]))) {
+                return result;
             }
+        }
+
+        unify();
+        std::lock_guard lock(solverCache->mutex);
+        solveLocked();
+        const MnaContext& ctx = solverCache->ctx;
+        if (ctx.systemSize() == 0) {
+            return result;
+        }
 
-            currentSolution = A.colPivHouseholderQr().solve(z);
-            const double currentTime = static_cast<double>(step) * timestepSeconds;
-            recordSample(currentSolution, currentTime);
+        const StampProgram& program = solverCache->program;
+        Eigen::VectorXd excitation;
+        if (options.sourceElement) {
+            excitation = Eigen::VectorXd::Zero(ctx.systemSize());
+            program.accumulateRhs(*options.sourceElement, 1.0, excitation);
+        } else {
+            program.assembleRhs(excitation);
+        }
+
+        result.referenceNodeId = ctx.groundId;
+        buildNodeColumns(ctx, nodes, supernodeResolver(), result.nodeIds, result.nodeIndex);
+        result.magnitude.assign(result.nodeIds.size() * result.pointCount(), 0.0);
+        result.phaseDegrees.assign(result.nodeIds.size() * result.pointCount(), 0.0);
+        result.solved = runAcSweep(program, excitation, ctx.indexToNodeId.size(), options.threads, result);
+        return result;
+    }
+
+    TransientResult Circuit::simulateTransient(double durationSeconds, double timestepSeconds) {
+        TransientOptions options;
+        options.durationSeconds = durationSeconds;
+        options.timestepSeconds = timestepSeconds;
+        return simulateTransient(options);
+    }
+
+    bool Circuit::simulateTransient(double durationSeconds, double timestepSeconds, TransientSink& sink) {
+        TransientOptions options;
+        options.durationSeconds = durationSeconds;
+        options.timestepSeconds = timestepSeconds;
+        return simulateTransient(options, sink);
+    }
 
-            for (auto& cap : capacitors) {
-                const double va = voltageAtNode(ctx, cap.a, currentSolution);
-                const double vb = voltageAtNode(ctx, cap.b, currentSolution);
-                cap.prevVoltage = va - vb;
+    TransientResult Circuit::simulateTransient(const TransientOptions& options) {
+        TransientCollector collector;
+        if (!simulateTransient(options, collector)) {
+            return {};
+        }
+        return collector.takeResult();
+    }
+
+    bool Circuit::simulateTransient(const TransientOptions& options, TransientSink& sink) {
+        const double timestepSeconds = options.timestepSeconds;
+        transientStatistics = {};
+        if (!validTransientOptions(options)) {
+            return false;
+        }
+
+        unify();
+        std::lock_guard lock(solverCache->mutex);
+        // Seeds the capacitors and compiles (or refreshes) the stamp program under the same lock, so a copy
+        // sharing the cache cannot swap in its own topology or values before the transient runs.
+        Eigen::VectorXd steadyState = solveLocked();
+        const MnaContext& ctx = solverCache->ctx;
+
+        const int systemSize = ctx.systemSize();
+        if (systemSize == 0) {
+            return false;
+        }
+
+        // solveLocked() above compiled (or refreshed) the stamp program for the current topology and values.
+        solverCache->transientSolver.setFactorization(solverOptions.factorization);
+        solverCache->transientSolver.setOrdering(solverOptions.ordering);
+        solverCache->transientSolver.setSymmetricPositiveDefinite(
+            solverOptions.useCholesky && symmetricPositiveElements(elements));
+        CompanionSystem system(solverCache->program, solverCache->transientSolver,
+            solverCache->transientSparse, solverCache->transientDense, options.method);
+        system.seed(steadyState);
+
+        TransientLayout layout;
+        layout.timestep = timestepSeconds;
+        layout.referenceNodeId = ctx.groundId;
+        layout.expectedSamples = transientSampleCount(options);
+        buildNodeColumns(ctx, nodes, supernodeResolver(), layout.nodeIds, layout.nodeIndex);
+
+        sink.begin(layout);
+        transientStatistics = integrateTransient(system, steadyState, options, layout.nodeIds.size(), sink);
+        sink.end();
+        return true;
+    }
+
+    EnsembleResult Circuit::simulateEnsemble(const EnsembleOptions& options) {
+        EnsembleResult result;
+        const TransientOptions& transient = options.transient;
+        if (!validTransientOptions(transient) || options.members.empty()) {
+            return result;
+        }
+
+        std::vector<EnsembleMember> members(options.members.size());
+        std::vector<Element> memberElements;
+        for (std::size_t m = 0; m < members.size(); ++m) {
+            memberElements = elements;
+            for (const auto& change : options.members[m]) {
+                if (change.elementIndex >= elements.size() || std::holds_alternative<Wire>(elements[change.elementIndex])) {
+                    return result;
+                }
+                assignElementValue(memberElements[change.elementIndex], static_cast<float>(change.value));
             }
+            defaultStampRegistry().coefficients(memberElements, members[m].coefficients);
+            members[m].coefficients.push_back(1.0);
+            members[m].symmetric = solverOptions.useCholesky && symmetricPositiveElements(memberElements);
+        }
+
+        unify();
+        std::lock_guard lock(solverCache->mutex);
+        // Compiles the stamp program for the current topology; the members only bring their own values.
+        solveLocked();
+        const MnaContext& ctx = solverCache->ctx;
+        if (ctx.systemSize() == 0) {
+            return result;
+        }
+        std::vector<int> observedRows;
+        if (!selectNodeColumns(ctx, nodes, supernodeResolver(), options.observedNodes,
+                result.nodeIds, result.nodeIndex, observedRows)) {
+            return result;
         }
 
+        EnsembleOutcome outcome = runEnsembleTransient(solverCache->program, members, options, solverOptions,
+            observedRows, ctx.indexToNodeId.size());
+        result.solved = true;
+        result.timestep = transient.timestepSeconds;
+        result.referenceNodeId = ctx.groundId;
+        result.times.resize(transientSampleCount(transient));
+        for (std::size_t k = 0; k < result.times.size(); ++k) {
+            result.times[k] = static_cast<double>(k) * transient.timestepSeconds;
+        }
+        result.memberSolved.assign(outcome.solved.begin(), outcome.solved.end());
+        result.failedMembers = static_cast<std::size_t>(std::count(outcome.solved.begin(), outcome.solved.end(), 0));
+        result.laneBatchedMembers = outcome.laneBatched;
+        result.waveforms = std::move(outcome.waveforms);
+        result.mean = std::move(outcome.mean);
+        result.stddev = std::move(outcome.stddev);
+        result.min = std::move(outcome.min);
+        result.max = std::move(outcome.max);
         return result;
     }
 }
@@ -0,0 +1,46 @@
+#ifndef CIRCUITX_PARALLELFOR_H
+#define CIRCUITX_PARALLELFOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace circuitx {
+    // Worker count for `tasks` independent tasks; 0 requests one worker per hardware thread.
+    inline unsigned resolveWorkerCount(unsigned requested, std::size_t tasks) {
+        unsigned workers = requested != 0 ? requested : std::max(1u, std::thread::hardware_concurrency());
+        return static_cast<unsigned>(std::min<std::size_t>(workers, std::max<std::size_t>(tasks, 1)));
+    }
+
+    /**
+     * Runs task(index, worker) for every index in [0, tasks) on `workers` threads. Tasks are handed out
+     * dynamically, so callers that need reproducible results must make each task self-contained and
+     * combine per-task outputs by index afterwards. worker is in [0, workers) and identifies the
+     * per-thread workspace to use. The calling thread acts as worker 0.
+     */
+    template<typename Task>
+    void parallelFor(std::size_t tasks, unsigned workers, Task&& task) {
+        if (tasks == 0) {
+            return;
+        }
+        workers = std::max(1u, workers);
+
+        std::atomic<std::size_t> next{0};
+        auto drain = [&](unsigned worker) {
+            for (std::size_t index = next.fetch_add(1); index < tasks; index = next.fetch_add(1)) {
+                task(index, worker);
+            }
+        };
+
+        std::vector<std::jthread> threads;
+        threads.reserve(workers - 1);
+        for (unsigned worker = 1; worker < workers; ++worker) {
+            threads.emplace_back(drain, worker);
+        }
+        drain(0);
+    }
+}
+
+#endif //CIRCUITX_PARALLELFOR_H
@@ -0,0 +1,197 @@
+#include "AmgPreconditioner.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace circuitx {
+    namespace {
+        // Levels at or below this size are solved directly.
+        constexpr Eigen::Index coarsestSize = 500;
+        constexpr std::size_t maxLevels = 25;
+        // Stop coarsening once a level keeps more than this share of its unknowns.
+        constexpr double minimumCoarsening = 0.8;
+        // j is a strong neighbor of i when |a_ij| >= strengthThreshold * sqrt(|a_ii a_jj|).
+        constexpr double strengthThreshold = 0.08;
+
+        template <typename Visit>
+        void forStrongNeighbors(const SparseMatrix& matrix, const Eigen::VectorXd& diagonal, int i, Visit&& visit) {
+            // The matrix is symmetric, so column i doubles as row i.
+            for (SparseMatrix::InnerIterator it(matrix, i); it; ++it) {
+                const auto j = static_cast<int>(it.row());
+                if (j != i && std::abs(it.value()) >= strengthThreshold * std::sqrt(std::abs(diagonal(i) * diagonal(j)))) {
+                    visit(j);
+                }
+            }
+        }
+
+        // Standard two-pass aggregation: seed an aggregate at every node whose strong neighborhood is
+        // still free, then attach each remaining node to an aggregate one of its strong neighbors
+        // joined in the first pass (every such node has one, or it would have seeded its own).
+        int aggregateNodes(const SparseMatrix& matrix, std::vector<int>& aggregate) {
+            const auto n = static_cast<int>(matrix.rows());
+            const Eigen::VectorXd diagonal = matrix.diagonal();
+            aggregate.assign(static_cast<std::size_t>(n), -1);
+            int count = 0;
+            for (int i = 0; i < n; ++i) {
+                if (aggregate[i] != -1) {
+                    continue;
+                }
+                bool free = true;
+                forStrongNeighbors(matrix, diagonal, i, [&](int j) { free = free && aggregate[j] == -1; });
+                if (!free) {
+                    continue;
+                }
+                aggregate[i] = count;
+                forStrongNeighbors(matrix, diagonal, i, [&](int j) { aggregate[j] = count; });
+                ++count;
+            }
+
+            const std::vector<int> seeded = aggregate;
+            for (int i = 0; i < n; ++i) {
+                if (aggregate[i] != -1) {
+                    continue;
+                }
+                forStrongNeighbors(matrix, diagonal, i, [&](int j) {
+                    if (aggregate[i] == -1 && seeded[j] != -1) {
+                        aggregate[i] = seeded[j];
+                    }
+                });
+            }
+            return count;
+        }
+
+        // P = (I - omega D^-1 A) P0 with P0 the 0/1 aggregate indicator. omega = 4 / (3 rho), where rho
+        // bounds the spectral radius of D^-1 A by Gershgorin (at most 2 for diagonally dominant nodal matrices).
+        SparseMatrix smoothedProlongation(const SparseMatrix& matrix, const std::vector<int>& aggregate, int count) {
+            const Eigen::Index n = matrix.rows();
+            const Eigen::VectorXd diagonal = matrix.diagonal();
+            double radius = 0.0;
+            for (Eigen::Index i = 0; i < n; ++i) {
+                if (diagonal(i) <= 0.0) {
+                    continue;
+                }
+                double rowSum = 0.0;
+                for (SparseMatrix::InnerIterator it(matrix, i); it; ++it) {
+                    rowSum += std::abs(it.value());
+                }
+                radius = std::max(radius, rowSum / diagonal(i));
+            }
+            const double omega = radius > 0.0 ? 4.0 / (3.0 * radius) : 0.0;
+
+            Triplets triplets;
+            triplets.reserve(static_cast<std::size_t>(matrix.nonZeros() + n));
+            for (Eigen::Index i = 0; i < n; ++i) {
+                const auto row = static_cast<int>(i);
+                triplets.emplace_back(row, aggregate[i], 1.0);
+                if (diagonal(i) <= 0.0) {
+                    continue;
+                }
+                const double scale = omega / diagonal(i);
+                for (SparseMatrix::InnerIterator it(matrix, i); it; ++it) {
+                    triplets.emplace_back(row, aggregate[it.row()], -scale * it.value());
+                }
+            }
+            SparseMatrix prolongation(n, count);
+            prolongation.setFromTriplets(triplets.begin(), triplets.end());
+            return prolongation;
+        }
+
+        SparseMatrix galerkinProduct(const SparseMatrix& prolongation, const SparseMatrix& matrix) {
+            const SparseMatrix product = matrix * prolongation;
+            return SparseMatrix(prolongation.transpose() * product);
+        }
+
+        Eigen::VectorXd inverseOf(const Eigen::VectorXd& diagonal) {
+            Eigen::VectorXd inverse(diagonal.size());
+            for (Eigen::Index i = 0; i < diagonal.size(); ++i) {
+                inverse(i) = diagonal(i) != 0.0 ? 1.0 / diagonal(i) : 0.0;
+            }
+            return inverse;
+        }
+
+        // One Gauss-Seidel sweep on a symmetric column-major matrix, forward or backward.
+        void gaussSeidel(const SparseMatrix& matrix, const Eigen::VectorXd& inverseDiagonal, const Eigen::VectorXd& rhs,
+            Eigen::VectorXd& x, bool forward) {
+            const Eigen::Index n = matrix.rows();
+            for (Eigen::Index k = 0; k < n; ++k) {
+                const Eigen::Index i = forward ? k : n - 1 - k;
+                double sum = rhs(i);
+                for (SparseMatrix::InnerIterator it(matrix, i); it; ++it) {
+                    if (it.row() != i) {
+                        sum -= it.value() * x(it.row());
+                    }
+                }
+                x(i) = sum * inverseDiagonal(i);
+            }
+        }
+    }
+
+    bool AmgPreconditioner::analyze(const SparseMatrix& matrix) {
+        finest = &matrix;
+        levels.clear();
+        levels.emplace_back();
+        std::vector<int> aggregate;
+        while (levels.size() < maxLevels) {
+            const SparseMatrix& current = operatorAt(levels.size() - 1);
+            const Eigen::Index n = current.rows();
+            if (n <= coarsestSize) {
+                break;
+            }
+            const int count = aggregateNodes(current, aggregate);
+            if (count == 0 || static_cast<double>(count) > minimumCoarsening * static_cast<double>(n)) {
+                break;
+            }
+            SparseMatrix prolongation = smoothedProlongation(current, aggregate, count);
+            SparseMatrix coarse = galerkinProduct(prolongation, current);
+            levels.back().prolongation = std::move(prolongation);
+            levels.emplace_back().matrix = std::move(coarse);
+        }
+        operatorsCurrent = true;
+        return true;
+    }
+
+    bool AmgPreconditioner::factorize(const SparseMatrix& matrix) {
+        if (levels.empty()) {
+            return false;
+        }
+        finest = &matrix;
+        if (!operatorsCurrent) {
+            for (std::size_t level = 0; level + 1 < levels.size(); ++level) {
+                levels[level + 1].matrix = galerkinProduct(levels[level].prolongation, operatorAt(level));
+            }
+        }
+        operatorsCurrent = false;
+
+        for (std::size_t level = 0; level < levels.size(); ++level) {
+            levels[level].inverseDiagonal = inverseOf(operatorAt(level).diagonal());
+        }
+        coarsest.compute(operatorAt(levels.size() - 1));
+        return coarsest.info() == Eigen::Success;
+    }
+
+    void AmgPreconditioner::apply(const Eigen::VectorXd& residual, Eigen::VectorXd& result) const {
+        cycle(0, residual, result);
+    }
+
+    const SparseMatrix& AmgPreconditioner::operatorAt(std::size_t level) const {
+        return level == 0 ? *finest : levels[level].matrix;
+    }
+
+    void AmgPreconditioner::cycle(std::size_t level, const Eigen::VectorXd& rhs, Eigen::VectorXd& x) const {
+        if (level + 1 == levels.size()) {
+            x = coarsest.solve(rhs);
+            return;
+        }
+        const SparseMatrix& matrix = operatorAt(level);
+        const Level& fine = levels[level];
+        const Level& coarse = levels[level + 1];
+
+        x.setZero(rhs.size());
+        gaussSeidel(matrix, fine.inverseDiagonal, rhs, x, true);
+        fine.residual.noalias() = rhs - matrix * x;
+        coarse.rhs.noalias() = fine.prolongation.transpose() * fine.residual;
+        cycle(level + 1, coarse.rhs, coarse.solution);
+        x.noalias() += fine.prolongation * coarse.solution;
+        gaussSeidel(matrix, fine.inverseDiagonal, rhs, x, false);
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef CIRCUITX_AMGPRECONDITIONER_H
+#define CIRCUITX_AMGPRECONDITIONER_H
+
+#include "LinearSolver.h"
+
+#include <vector>
+
+namespace circuitx {
+    /**
+     * Smoothed-aggregation algebraic multigrid for nodal conductance matrices, applied as one
+     * symmetric V-cycle (forward Gauss-Seidel down, backward Gauss-Seidel up) so it stays a valid
+     * CG preconditioner.
+     *
+     * analyze() builds the hierarchy: strongly coupled nodes are grouped into aggregates, each
+     * aggregate becomes one coarse unknown, and the piecewise-constant interpolation is smoothed by
+     * one damped Jacobi step. The aggregates and prolongations only depend on the topology (and the
+     * values it was analyzed with), so factorize() merely recomputes the Galerkin coarse operators
+     * P^T A P, the smoother diagonals and the coarsest LDL^T for new values.
+     */
+    class AmgPreconditioner {
+    public:
+        bool analyze(const SparseMatrix& matrix);
+        bool factorize(const SparseMatrix& matrix);
+        void apply(const Eigen::VectorXd& residual, Eigen::VectorXd& result) const;
+
+        [[nodiscard]] std::size_t levelCount() const { return levels.size(); }
+
+    private:
+        struct Level {
+            SparseMatrix matrix;        // Galerkin operator; empty on the finest level, which is the caller's
+            SparseMatrix prolongation;  // next coarser level -> this one; empty on the coarsest
+            Eigen::VectorXd inverseDiagonal;
+            // V-cycle scratch, reused across applications.
+            mutable Eigen::VectorXd rhs;
+            mutable Eigen::VectorXd solution;
+            mutable Eigen::VectorXd residual;
+        };
+
+        [[nodiscard]] const SparseMatrix& operatorAt(std::size_t level) const;
+        void cycle(std::size_t level, const Eigen::VectorXd& rhs, Eigen::VectorXd& x) const;
+
+        const SparseMatrix* finest = nullptr;
+        std::vector<Level> levels;
+        Eigen::SimplicialLDLT<SparseMatrix> coarsest;
+        bool operatorsCurrent = false; // analyze() already built the coarse operators for these values
+    };
+}
+
+#endif //CIRCUITX_AMGPRECONDITIONER_H
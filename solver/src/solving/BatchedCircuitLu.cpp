@@ -0,0 +1,209 @@
+#include "BatchedCircuitLu.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace circuitx {
+    namespace {
+        // target -= a * b, lane by lane.
+        template <int Width>
+        inline void subtractProduct(Lanes<Width>& target, const Lanes<Width>& a, const Lanes<Width>& b) {
+            for (int l = 0; l < Width; ++l) {
+                target.v[l] -= a.v[l] * b.v[l];
+            }
+        }
+
+        template <int Width>
+        inline void zero(Lanes<Width>& lanes) {
+            for (int l = 0; l < Width; ++l) {
+                lanes.v[l] = 0.0;
+            }
+        }
+    }
+
+    template <int Width>
+    bool BatchedCircuitLu<Width>::analyze(const Eigen::SparseMatrix<double>& pattern, FillOrdering ordering) {
+        pivoted = false;
+        if (!reference.analyze(pattern, ordering)) {
+            return false;
+        }
+        trial = reference;
+        scratch = pattern;
+        const auto n = static_cast<std::size_t>(reference.size);
+        diagonal.assign(n, Lane{});
+        offValues.assign(reference.offEntries.size(), Lane{});
+        dense.assign(n, Lane{});
+        permuted.assign(n, Lane{});
+        work.assign(n, Lane{});
+        return true;
+    }
+
+    template <int Width>
+    bool BatchedCircuitLu<Width>::pivotOnLane(const Lane* values, int lane) {
+        double* target = scratch.valuePtr();
+        for (Eigen::Index p = 0; p < scratch.nonZeros(); ++p) {
+            target[p] = values[p].v[lane];
+        }
+        ++pivotCount;
+        // A failed factorize() leaves its CircuitLu half rewritten, so it must not be the one the lanes replay.
+        if (!trial.factorize(scratch)) {
+            return false;
+        }
+        swapPivoting();
+        pivoted = true;
+        return true;
+    }
+
+    template <int Width>
+    void BatchedCircuitLu<Width>::swapPivoting() {
+        std::swap(reference, trial);
+        const auto n = static_cast<std::size_t>(reference.size);
+        lowerStart.assign(1, 0);
+        upperStart.assign(1, 0);
+        for (std::size_t k = 0; k < n; ++k) {
+            lowerStart.push_back(lowerStart.back() + static_cast<int>(reference.lower[k].rows.size()));
+            upperStart.push_back(upperStart.back() + static_cast<int>(reference.upper[k].rows.size()));
+        }
+        lowerValues.assign(static_cast<std::size_t>(lowerStart.back()), Lane{});
+        upperValues.assign(static_cast<std::size_t>(upperStart.back()), Lane{});
+    }
+
+    template <int Width>
+    unsigned BatchedCircuitLu<Width>::factorize(const Lane* values) {
+        if (!reference.isAnalyzed()) {
+            return 0;
+        }
+        unsigned usable = pivoted ? refactorLanes(values) : 0;
+        // Repivot on a failing lane that has a factorization of its own. The new sequence replaces the
+        // old one unless it carries fewer lanes (a singular lane can make any sequence fail).
+        for (int lane = 0; lane < Width && usable != allLanes; ++lane) {
+            if ((usable >> lane & 1u) != 0 || !pivotOnLane(values, lane)) {
+                continue;
+            }
+            const unsigned repivoted = refactorLanes(values);
+            if (std::popcount(repivoted) >= std::popcount(usable)) {
+                usable = repivoted;
+                break;
+            }
+            swapPivoting();
+            usable = refactorLanes(values);
+        }
+        return usable;
+    }
+
+    template <int Width>
+    unsigned BatchedCircuitLu<Width>::refactorLanes(const Lane* values) {
+        const std::vector<CircuitLu::Entry>& offEntries = reference.offEntries;
+        for (std::size_t e = 0; e < offEntries.size(); ++e) {
+            offValues[e] = values[offEntries[e].value];
+        }
+
+        // CircuitLu::refactorBlock() on every lane at once; the diagonal blocks follow each other, so one
+        // pass over the permuted columns covers them all.
+        unsigned usable = allLanes;
+        const int n = reference.size;
+        for (int j = 0; j < n; ++j) {
+            for (int e = reference.blockEntryStart[j]; e < reference.blockEntryStart[j + 1]; ++e) {
+                const CircuitLu::Entry& entry = reference.blockEntries[e];
+                Lane& target = dense[reference.pivotOf[entry.row]];
+                for (int l = 0; l < Width; ++l) {
+                    target.v[l] += values[entry.value].v[l];
+                }
+            }
+
+            const std::vector<int>& upperRows = reference.upper[j].rows;
+            Lane* u = upperValues.data() + upperStart[j];
+            for (std::size_t q = 0; q < upperRows.size(); ++q) {
+                const int k = upperRows[q];
+                const Lane x = dense[k];
+                u[q] = x;
+                const std::vector<int>& rows = reference.lower[k].rows;
+                const Lane* l = lowerValues.data() + lowerStart[k];
+                for (std::size_t r = 0; r < rows.size(); ++r) {
+                    subtractProduct(dense[rows[r]], l[r], x);
+                }
+            }
+
+            const std::vector<int>& lowerRows = reference.lower[j].rows;
+            Lane* l = lowerValues.data() + lowerStart[j];
+            const Lane pivot = dense[j];
+            Lane largest{};
+            for (const int row : lowerRows) {
+                for (int lane = 0; lane < Width; ++lane) {
+                    largest.v[lane] = std::max(largest.v[lane], std::abs(dense[row].v[lane]));
+                }
+            }
+            for (int lane = 0; lane < Width; ++lane) {
+                const double p = pivot.v[lane];
+                if (!(p != 0.0 && std::isfinite(p) && std::isfinite(largest.v[lane])
+                        && std::abs(p) >= CircuitLu::pivotTolerance * largest.v[lane])) {
+                    usable &= ~(1u << lane);
+                }
+            }
+            for (std::size_t r = 0; r < lowerRows.size(); ++r) {
+                Lane& source = dense[lowerRows[r]];
+                for (int lane = 0; lane < Width; ++lane) {
+                    l[r].v[lane] = source.v[lane] / pivot.v[lane];
+                }
+                zero(source);
+            }
+            for (const int k : upperRows) {
+                zero(dense[k]);
+            }
+            zero(dense[j]);
+            diagonal[j] = pivot;
+        }
+        return usable;
+    }
+
+    template <int Width>
+    void BatchedCircuitLu<Width>::solve(const Lane* rhs, Lane* solution) {
+        const int n = reference.size;
+        const std::vector<int>& pivotRow = reference.pivotRow;
+        const std::vector<int>& blockStart = reference.blockStart;
+        for (int k = 0; k < n; ++k) {
+            permuted[k] = rhs[reference.rowPermutation[k]];
+        }
+
+        // Block back substitution as in CircuitLu::solveColumn().
+        for (std::size_t b = blockStart.size() - 1; b-- > 0;) {
+            const int begin = blockStart[b];
+            const int end = blockStart[b + 1];
+            for (int k = begin; k < end; ++k) {
+                work[k] = permuted[pivotRow[k]];
+            }
+            for (int k = begin; k < end; ++k) {
+                const Lane x = work[k];
+                const std::vector<int>& rows = reference.lower[k].rows;
+                const Lane* l = lowerValues.data() + lowerStart[k];
+                for (std::size_t q = 0; q < rows.size(); ++q) {
+                    subtractProduct(work[rows[q]], l[q], x);
+                }
+            }
+            for (int k = end; k-- > begin;) {
+                for (int lane = 0; lane < Width; ++lane) {
+                    work[k].v[lane] /= diagonal[k].v[lane];
+                }
+                const Lane x = work[k];
+                const std::vector<int>& rows = reference.upper[k].rows;
+                const Lane* u = upperValues.data() + upperStart[k];
+                for (std::size_t q = 0; q < rows.size(); ++q) {
+                    subtractProduct(work[rows[q]], u[q], x);
+                }
+            }
+            for (int k = begin; k < end; ++k) {
+                for (int e = reference.offEntryStart[k]; e < reference.offEntryStart[k + 1]; ++e) {
+                    subtractProduct(permuted[reference.offEntries[e].row], offValues[e], work[k]);
+                }
+            }
+        }
+
+        for (int k = 0; k < n; ++k) {
+            solution[reference.columnPermutation[k]] = work[k];
+        }
+    }
+
+    template class BatchedCircuitLu<4>;
+    template class BatchedCircuitLu<8>;
+}
@@ -0,0 +1,76 @@
+#ifndef CIRCUITX_BATCHEDCIRCUITLU_H
+#define CIRCUITX_BATCHEDCIRCUITLU_H
+
+#include "CircuitLu.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace circuitx {
+    // One value per variant; the width matches a SIMD register (4 doubles for AVX2, 8 for AVX-512).
+    template <int Width>
+    struct alignas(sizeof(double) * Width) Lanes {
+        double v[Width];
+    };
+
+    /**
+     * CircuitLu for Width matrices with the same sparsity pattern, factored and solved together: every
+     * entry of L, U and the work vectors stores one value per lane, so each index is loaded once and
+     * the arithmetic runs as fixed-width lane loops the compiler maps onto SIMD registers.
+     *
+     * The lanes share one pivot sequence, taken from a scalar CircuitLu::factorize() of one lane and
+     * replayed numerically for all of them (the refactorize() path). A lane whose replayed pivot fails
+     * the threshold test triggers a scalar repivot on that lane; the new sequence is kept only if it
+     * succeeds and carries at least as many lanes as the old one. Lanes that still fail are left out of
+     * the returned mask and should be solved on their own.
+     */
+    template <int Width>
+    class BatchedCircuitLu {
+    public:
+        using Lane = Lanes<Width>;
+        static constexpr int width = Width;
+        static constexpr unsigned allLanes = (1u << Width) - 1;
+
+        // False for structurally singular patterns (see CircuitLu::analyze).
+        bool analyze(const Eigen::SparseMatrix<double>& pattern, FillOrdering ordering = FillOrdering::Automatic);
+        // values[p] holds the lanes of entry p of the pattern's value array. Returns the mask of lanes
+        // with a usable factorization.
+        unsigned factorize(const Lane* values);
+        // Solves every lane of rhs (one Lane per row); lanes outside the last factorize() mask are garbage.
+        // Not const: the permutation scratch is kept between calls.
+        void solve(const Lane* rhs, Lane* solution);
+
+        [[nodiscard]] bool isAnalyzed() const { return reference.isAnalyzed(); }
+        [[nodiscard]] int systemSize() const { return reference.size; }
+        // Scalar factorizations run to choose (or re-choose) the shared pivot sequence.
+        [[nodiscard]] std::size_t pivotings() const { return pivotCount; }
+
+    private:
+        unsigned refactorLanes(const Lane* values);
+        bool pivotOnLane(const Lane* values, int lane);
+        void swapPivoting();
+
+        CircuitLu reference;                 // symbolic analysis, pivot sequence and L/U patterns
+        CircuitLu trial;                     // repivots run here, so a failed one leaves `reference` intact
+        Eigen::SparseMatrix<double> scratch; // one lane's values for the scalar pivoting pass
+        bool pivoted = false;
+        std::size_t pivotCount = 0;
+
+        // Lane values of L and U; column k occupies [lowerStart[k], lowerStart[k + 1]) in the order of
+        // reference.lower[k].rows (upper likewise).
+        std::vector<int> lowerStart;
+        std::vector<int> upperStart;
+        std::vector<Lane> lowerValues;
+        std::vector<Lane> upperValues;
+        std::vector<Lane> diagonal;
+        std::vector<Lane> offValues;
+        std::vector<Lane> dense;
+        std::vector<Lane> permuted;
+        std::vector<Lane> work;
+    };
+
+    extern template class BatchedCircuitLu<4>;
+    extern template class BatchedCircuitLu<8>;
+}
+
+#endif //CIRCUITX_BATCHEDCIRCUITLU_H
@@ -0,0 +1,207 @@
+#include "BlockSolver.h"
+
+#include "../parallel/ParallelFor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+
+namespace circuitx {
+    void BlockSolver::configure(const StampProgram& program, const SolverOptions& options) {
+        blocks.clear();
+        systemSize = program.systemSize();
+        const std::vector<StampProgram::MatrixEntry> entries = program.matrixEntries();
+
+        std::vector<int> parent(static_cast<std::size_t>(systemSize));
+        std::iota(parent.begin(), parent.end(), 0);
+        auto find = [&](int x) {
+            while (parent[x] != x) {
+                parent[x] = parent[parent[x]];
+                x = parent[x];
+            }
+            return x;
+        };
+        for (const auto& entry : entries) {
+            const int a = find(entry.row);
+            const int b = find(entry.col);
+            if (a != b) {
+                parent[std::max(a, b)] = std::min(a, b);
+            }
+        }
+
+        // Blocks are numbered by their smallest unknown, so the layout is deterministic.
+        std::vector<int> blockOfRoot(static_cast<std::size_t>(systemSize), -1);
+        std::vector<int> blockOf(static_cast<std::size_t>(systemSize));
+        std::vector<int> localIndex(static_cast<std::size_t>(systemSize));
+        for (int unknown = 0; unknown < systemSize; ++unknown) {
+            const int root = find(unknown);
+            if (blockOfRoot[root] < 0) {
+                blockOfRoot[root] = static_cast<int>(blocks.size());
+                blocks.emplace_back();
+            }
+            Block& block = blocks[static_cast<std::size_t>(blockOfRoot[root])];
+            blockOf[unknown] = blockOfRoot[root];
+            localIndex[unknown] = static_cast<int>(block.unknowns.size());
+            block.unknowns.push_back(unknown);
+        }
+
+        std::vector<Triplets> structure(blocks.size());
+        for (const auto& entry : entries) {
+            const auto b = static_cast<std::size_t>(blockOf[entry.row]);
+            structure[b].emplace_back(localIndex[entry.row], localIndex[entry.col], 0.0);
+        }
+
+        for (std::size_t b = 0; b < blocks.size(); ++b) {
+            Block& block = blocks[b];
+            const auto size = static_cast<int>(block.unknowns.size());
+            // An unknown no stamp touches stays a 1x1 zero block; dense QR solves it to 0.
+            block.sparse = !structure[b].empty() && useSparseBackend(options, size);
+            block.solver.setFactorization(options.factorization);
+            block.solver.setOrdering(options.ordering);
+            if (block.sparse) {
+                block.sparseMatrix.resize(size, size);
+                block.sparseMatrix.setFromTriplets(structure[b].begin(), structure[b].end());
+                block.sparseMatrix.makeCompressed();
+            } else {
+                block.denseMatrix = Eigen::MatrixXd::Zero(size, size);
+            }
+        }
+
+        for (const auto& entry : entries) {
+            Block& block = blocks[static_cast<std::size_t>(blockOf[entry.row])];
+            const int row = localIndex[entry.row];
+            const int col = localIndex[entry.col];
+            int slot = 0;
+            if (block.sparse) {
+                const int* begin = block.sparseMatrix.innerIndexPtr() + block.sparseMatrix.outerIndexPtr()[col];
+                const int* end = block.sparseMatrix.innerIndexPtr() + block.sparseMatrix.outerIndexPtr()[col + 1];
+                slot = static_cast<int>(std::lower_bound(begin, end, row) - block.sparseMatrix.innerIndexPtr());
+            } else {
+                slot = col * static_cast<int>(block.unknowns.size()) + row;
+            }
+            block.gathers.push_back({entry.slot, slot});
+        }
+
+        // Spawning threads only pays off once the blocks carry real work.
+        workers = systemSize >= options.parallelBlockThreshold
+            ? resolveWorkerCount(options.threads, blocks.size())
+            : 1;
+        configured = true;
+    }
+
+    std::size_t BlockSolver::symbolicAnalyses() const {
+        std::size_t total = 0;
+        for (const auto& block : blocks) {
+            total += block.solver.symbolicAnalyses();
+        }
+        return total;
+    }
+
+    void BlockSolver::setSymmetricPositiveDefinite(bool symmetric) {
+        for (auto& block : blocks) {
+            block.solver.setSymmetricPositiveDefinite(symmetric);
+        }
+    }
+
+    bool BlockSolver::isSymmetric() const {
+        return std::ranges::all_of(blocks, [](const Block& block) { return block.solver.isSymmetric(); });
+    }
+
+    std::size_t BlockSolver::factorNonZeros() const {
+        std::size_t total = 0;
+        for (const auto& block : blocks) {
+            total += block.solver.factorNonZeros();
+        }
+        return total;
+    }
+
+    FillOrdering BlockSolver::ordering() const {
+        const Block* largest = nullptr;
+        for (const auto& block : blocks) {
+            if (block.sparse && (largest == nullptr || block.unknowns.size() > largest->unknowns.size())) {
+                largest = &block;
+            }
+        }
+        return largest == nullptr ? FillOrdering::Natural : largest->solver.ordering();
+    }
+
+    template<typename Task>
+    void BlockSolver::forEachBlock(Task&& task) const {
+        if (workers > 1) {
+            parallelFor(blocks.size(), workers, [&](std::size_t index, unsigned) { task(index); });
+            return;
+        }
+        for (std::size_t index = 0; index < blocks.size(); ++index) {
+            task(index);
+        }
+    }
+
+    bool BlockSolver::factorize(const double* fullValues) {
+        std::atomic<bool> factored{true};
+        forEachBlock([&](std::size_t index) {
+            Block& block = blocks[index];
+            double* values = block.sparse ? block.sparseMatrix.valuePtr() : block.denseMatrix.data();
+            for (const auto& gather : block.gathers) {
+                values[gather.blockSlot] = fullValues[gather.fullSlot];
+            }
+            const bool ok = block.sparse ? block.solver.factorize(block.sparseMatrix)
+                                         : block.solver.factorize(block.denseMatrix);
+            if (!ok) {
+                factored = false;
+            }
+        });
+        return factored;
+    }
+
+    Eigen::VectorXd BlockSolver::solve(const Eigen::VectorXd& rhs) const {
+        Eigen::VectorXd solution = Eigen::VectorXd::Zero(systemSize);
+        forEachBlock([&](std::size_t index) {
+            const Block& block = blocks[index];
+            Eigen::VectorXd local(static_cast<Eigen::Index>(block.unknowns.size()));
+            for (std::size_t i = 0; i < block.unknowns.size(); ++i) {
+                local(static_cast<Eigen::Index>(i)) = rhs(block.unknowns[i]);
+            }
+            const Eigen::VectorXd x = block.solver.solve(local);
+            for (std::size_t i = 0; i < block.unknowns.size(); ++i) {
+                solution(block.unknowns[i]) = x(static_cast<Eigen::Index>(i));
+            }
+        });
+        return solution;
+    }
+
+    Eigen::MatrixXd BlockSolver::solveBlock(const Eigen::MatrixXd& rhs) const {
+        Eigen::MatrixXd solution = Eigen::MatrixXd::Zero(systemSize, rhs.cols());
+        forEachBlock([&](std::size_t index) {
+            const Block& block = blocks[index];
+            Eigen::MatrixXd local(static_cast<Eigen::Index>(block.unknowns.size()), rhs.cols());
+            for (std::size_t i = 0; i < block.unknowns.size(); ++i) {
+                local.row(static_cast<Eigen::Index>(i)) = rhs.row(block.unknowns[i]);
+            }
+            const Eigen::MatrixXd x = block.solver.solveBlock(local);
+            for (std::size_t i = 0; i < block.unknowns.size(); ++i) {
+                solution.row(block.unknowns[i]) = x.row(static_cast<Eigen::Index>(i));
+            }
+        });
+        return solution;
+    }
+
+    bool BlockSolver::canSolveTransposed() const {
+        return std::all_of(blocks.begin(), blocks.end(), [](const Block& block) { return block.solver.canSolveTransposed(); });
+    }
+
+    Eigen::VectorXd BlockSolver::solveTransposed(const Eigen::VectorXd& rhs) const {
+        Eigen::VectorXd solution = Eigen::VectorXd::Zero(systemSize);
+        forEachBlock([&](std::size_t index) {
+            const Block& block = blocks[index];
+            Eigen::VectorXd local(static_cast<Eigen::Index>(block.unknowns.size()));
+            for (std::size_t i = 0; i < block.unknowns.size(); ++i) {
+                local(static_cast<Eigen::Index>(i)) = rhs(block.unknowns[i]);
+            }
+            const Eigen::VectorXd x = block.solver.solveTransposed(local);
+            for (std::size_t i = 0; i < block.unknowns.size(); ++i) {
+                solution(block.unknowns[i]) = x(static_cast<Eigen::Index>(i));
+            }
+        });
+        return solution;
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef CIRCUITX_BLOCKSOLVER_H
+#define CIRCUITX_BLOCKSOLVER_H
+
+#include "LinearSolver.h"
+#include "../stamping/StampProgram.h"
+
+#include <circuitx/circuit.hpp>
+
+#include <deque>
+#include <vector>
+
+namespace circuitx {
+    inline bool useSparseBackend(const SolverOptions& options, int systemSize) {
+        switch (options.backend) {
+            case MatrixBackend::Dense:
+                return false;
+            case MatrixBackend::Sparse:
+            case MatrixBackend::Iterative:
+                return true;
+            case MatrixBackend::Automatic:
+                break;
+        }
+        return systemSize >= options.sparseThreshold;
+    }
+
+    /**
+     * Solves an MNA system as independent diagonal blocks. configure() splits the unknowns into the
+     * connected components of the program's matrix structure (ground is already eliminated, so
+     * subcircuits that only share ground fall apart) and records, per block, which full-matrix value
+     * slots feed which block slots. factorize() then gathers each block from the assembled value array
+     * and factors the blocks independently, in parallel for large systems.
+     */
+    class BlockSolver {
+    public:
+        void configure(const StampProgram& program, const SolverOptions& options);
+
+        [[nodiscard]] bool isConfigured() const { return configured; }
+        [[nodiscard]] std::size_t blockCount() const { return blocks.size(); }
+        [[nodiscard]] std::size_t symbolicAnalyses() const;
+        // Summed over the blocks; dense blocks count n^2.
+        [[nodiscard]] std::size_t factorNonZeros() const;
+        // Ordering of the largest sparse block.
+        [[nodiscard]] FillOrdering ordering() const;
+
+        // fullValues is the value array produced by StampProgram::assemble (sparse values or dense storage).
+        void setSymmetricPositiveDefinite(bool symmetric);
+        // Every block ended up with a Cholesky-type factorization.
+        [[nodiscard]] bool isSymmetric() const;
+
+        bool factorize(const double* fullValues);
+        [[nodiscard]] Eigen::VectorXd solve(const Eigen::VectorXd& rhs) const;
+        [[nodiscard]] Eigen::MatrixXd solveBlock(const Eigen::MatrixXd& rhs) const;
+        // A^T x = rhs block by block; every block must support it (LinearSolver::canSolveTransposed).
+        [[nodiscard]] bool canSolveTransposed() const;
+        [[nodiscard]] Eigen::VectorXd solveTransposed(const Eigen::VectorXd& rhs) const;
+
+    private:
+        struct Gather {
+            int fullSlot = 0;
+            int blockSlot = 0;
+        };
+
+        struct Block {
+            std::vector<int> unknowns; // global rows, ascending
+            std::vector<Gather> gathers;
+            bool sparse = false;
+            SparseMatrix sparseMatrix;
+            Eigen::MatrixXd denseMatrix;
+            LinearSolver solver;
+        };
+
+        template<typename Task>
+        void forEachBlock(Task&& task) const;
+
+        std::deque<Block> blocks; // LinearSolver is not movable
+        int systemSize = 0;
+        unsigned workers = 1;
+        bool configured = false;
+    };
+}
+
+#endif //CIRCUITX_BLOCKSOLVER_H
@@ -0,0 +1,573 @@
+#include "CircuitLu.h"
+
+#include "FillOrdering.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace circuitx {
+    namespace {
+        // Row i of the result is matched to column columnOfRow[i], giving A(:, columnOfRow) a zero-free
+        // diagonal. Cheap assignment first, then depth-first augmenting paths (MC21). False if the
+        // matrix is structurally singular.
+        bool maximumTransversal(int n, const int* outer, const int* inner, std::vector<int>& columnOfRow) {
+            columnOfRow.assign(static_cast<std::size_t>(n), -1);
+            std::vector<int> visitedBy(static_cast<std::size_t>(n), -1);
+            std::vector<int> cursor(static_cast<std::size_t>(n));
+            std::vector<int> stack;
+            std::vector<int> via; // via[t] leads from stack[t] to stack[t + 1]
+
+            for (int j = 0; j < n; ++j) {
+                bool matched = false;
+                for (int p = outer[j]; p < outer[j + 1]; ++p) {
+                    if (columnOfRow[inner[p]] < 0) {
+                        columnOfRow[inner[p]] = j;
+                        matched = true;
+                        break;
+                    }
+                }
+                if (matched) {
+                    continue;
+                }
+
+                stack.assign(1, j);
+                via.clear();
+                cursor[j] = outer[j];
+                int freeRow = -1;
+                while (!stack.empty() && freeRow < 0) {
+                    const int column = stack.back();
+                    bool descended = false;
+                    for (int& p = cursor[column]; p < outer[column + 1]; ++p) {
+                        const int row = inner[p];
+                        if (visitedBy[row] == j) {
+                            continue;
+                        }
+                        visitedBy[row] = j;
+                        if (columnOfRow[row] < 0) {
+                            freeRow = row;
+                            break;
+                        }
+                        const int next = columnOfRow[row];
+                        via.push_back(row);
+                        cursor[next] = outer[next];
+                        stack.push_back(next);
+                        ++p;
+                        descended = true;
+                        break;
+                    }
+                    if (freeRow < 0 && !descended) {
+                        stack.pop_back();
+                        if (!via.empty()) {
+                            via.pop_back();
+                        }
+                    }
+                }
+                if (freeRow < 0) {
+                    return false;
+                }
+
+                columnOfRow[freeRow] = stack.back();
+                for (std::size_t t = via.size(); t-- > 0;) {
+                    columnOfRow[via[t]] = stack[t];
+                }
+            }
+            return true;
+        }
+
+        // Strongly connected components of the graph with an edge k -> i for every A(i, columnOfRow[k]).
+        // Tarjan emits a component only after everything it reaches, so numbering nodes in emission
+        // order yields block *upper* triangular form. order lists the nodes, blockStart the boundaries.
+        void stronglyConnectedBlocks(int n, const int* outer, const int* inner, const std::vector<int>& columnOfRow,
+            std::vector<int>& order, std::vector<int>& blockStart) {
+            std::vector<int> index(static_cast<std::size_t>(n), -1);
+            std::vector<int> low(static_cast<std::size_t>(n));
+            std::vector<int> cursor(static_cast<std::size_t>(n));
+            std::vector<char> onStack(static_cast<std::size_t>(n), 0);
+            std::vector<int> componentStack;
+            std::vector<int> callStack;
+            order.clear();
+            order.reserve(static_cast<std::size_t>(n));
+            blockStart.assign(1, 0);
+            int counter = 0;
+
+            auto enter = [&](int node) {
+                index[node] = low[node] = counter++;
+                cursor[node] = outer[columnOfRow[node]];
+                componentStack.push_back(node);
+                onStack[node] = 1;
+                callStack.push_back(node);
+            };
+
+            for (int start = 0; start < n; ++start) {
+                if (index[start] >= 0) {
+                    continue;
+                }
+                enter(start);
+                while (!callStack.empty()) {
+                    const int node = callStack.back();
+                    const int end = outer[columnOfRow[node] + 1];
+                    bool descended = false;
+                    while (cursor[node] < end) {
+                        const int next = inner[cursor[node]++];
+                        if (index[next] < 0) {
+                            enter(next);
+                            descended = true;
+                            break;
+                        }
+                        if (onStack[next]) {
+                            low[node] = std::min(low[node], index[next]);
+                        }
+                    }
+                    if (descended) {
+                        continue;
+                    }
+
+                    callStack.pop_back();
+                    if (!callStack.empty()) {
+                        low[callStack.back()] = std::min(low[callStack.back()], low[node]);
+                    }
+                    if (low[node] == index[node]) {
+                        int member = -1;
+                        do {
+                            member = componentStack.back();
+                            componentStack.pop_back();
+                            onStack[member] = 0;
+                            order.push_back(member);
+                        } while (member != node);
+                        blockStart.push_back(static_cast<int>(order.size()));
+                    }
+                }
+            }
+        }
+    }
+
+    bool CircuitLu::analyze(const Eigen::SparseMatrix<double>& matrix, FillOrdering ordering) {
+        analyzed = false;
+        factored = false;
+        if (matrix.rows() != matrix.cols() || !matrix.isCompressed()) {
+            return false;
+        }
+        size = static_cast<int>(matrix.rows());
+        const int n = size;
+        const int* outer = matrix.outerIndexPtr();
+        const int* inner = matrix.innerIndexPtr();
+
+        std::vector<int> columnOfRow;
+        if (!maximumTransversal(n, outer, inner, columnOfRow)) {
+            return false;
+        }
+        std::vector<int> order;
+        stronglyConnectedBlocks(n, outer, inner, columnOfRow, order, blockStart);
+
+        const auto blocks = blockStart.size() - 1;
+        blockOf.resize(static_cast<std::size_t>(n));
+        std::vector<int> blockOfNode(static_cast<std::size_t>(n));
+        for (std::size_t b = 0; b < blocks; ++b) {
+            for (int k = blockStart[b]; k < blockStart[b + 1]; ++k) {
+                blockOf[k] = static_cast<int>(b);
+                blockOfNode[order[k]] = static_cast<int>(b);
+            }
+        }
+
+        // Fill-reducing ordering of each non-trivial diagonal block; the permutation stays symmetric so
+        // the diagonal stays zero-free.
+        std::vector<int> local(static_cast<std::size_t>(n));
+        std::vector<Eigen::Triplet<double>> triplets;
+        usedOrdering = FillOrdering::Natural;
+        int largestOrdered = 0;
+        for (std::size_t b = 0; b < blocks; ++b) {
+            const int begin = blockStart[b];
+            const int blockSize = blockStart[b + 1] - begin;
+            if (blockSize < 3) {
+                continue;
+            }
+            for (int t = 0; t < blockSize; ++t) {
+                local[order[begin + t]] = t;
+            }
+            triplets.clear();
+            for (int t = 0; t < blockSize; ++t) {
+                const int column = columnOfRow[order[begin + t]];
+                for (int p = outer[column]; p < outer[column + 1]; ++p) {
+                    if (blockOfNode[inner[p]] == static_cast<int>(b)) {
+                        triplets.emplace_back(local[inner[p]], t, 1.0);
+                    }
+                }
+            }
+            Eigen::SparseMatrix<double> pattern(blockSize, blockSize);
+            pattern.setFromTriplets(triplets.begin(), triplets.end());
+            FillOrdering used = FillOrdering::Natural;
+            const std::vector<int> permutation = computeFillOrdering(pattern, ordering, &used);
+            if (blockSize > largestOrdered) {
+                largestOrdered = blockSize;
+                usedOrdering = used;
+            }
+            const std::vector<int> previous(order.begin() + begin, order.begin() + begin + blockSize);
+            for (int t = 0; t < blockSize; ++t) {
+                order[begin + t] = previous[permutation[t]];
+            }
+        }
+
+        rowPermutation = order;
+        columnPermutation.resize(static_cast<std::size_t>(n));
+        std::vector<int> positionOfRow(static_cast<std::size_t>(n));
+        for (int k = 0; k < n; ++k) {
+            columnPermutation[k] = columnOfRow[order[k]];
+            positionOfRow[order[k]] = k;
+        }
+
+        blockEntryStart.assign(1, 0);
+        offEntryStart.assign(1, 0);
+        blockEntries.clear();
+        offEntries.clear();
+        for (int k = 0; k < n; ++k) {
+            const int column = columnPermutation[k];
+            for (int p = outer[column]; p < outer[column + 1]; ++p) {
+                const int row = positionOfRow[inner[p]];
+                if (blockOf[row] == blockOf[k]) {
+                    blockEntries.push_back({p, row});
+                } else {
+                    offEntries.push_back({p, row}); // always in an earlier block
+                }
+            }
+            blockEntryStart.push_back(static_cast<int>(blockEntries.size()));
+            offEntryStart.push_back(static_cast<int>(offEntries.size()));
+        }
+        offValues.assign(offEntries.size(), 0.0);
+
+        lower.assign(static_cast<std::size_t>(n), Column{});
+        upper.assign(static_cast<std::size_t>(n), Column{});
+        diagonal.assign(static_cast<std::size_t>(n), 0.0);
+        pivotRow.assign(static_cast<std::size_t>(n), 0);
+        pivotOf.assign(static_cast<std::size_t>(n), -1);
+        dense.assign(static_cast<std::size_t>(n), 0.0);
+        visited.assign(static_cast<std::size_t>(n), -1);
+        dfsNext.assign(static_cast<std::size_t>(n), 0);
+        analyzed = true;
+        return true;
+    }
+
+    bool CircuitLu::factorize(const Eigen::SparseMatrix<double>& matrix) {
+        factored = false;
+        if (!analyzed) {
+            return false;
+        }
+        const double* values = matrix.valuePtr();
+        for (std::size_t e = 0; e < offEntries.size(); ++e) {
+            offValues[e] = values[offEntries[e].value];
+        }
+        std::fill(visited.begin(), visited.end(), -1);
+        for (std::size_t b = 0; b + 1 < blockStart.size(); ++b) {
+            if (!factorBlock(values, blockStart[b], blockStart[b + 1])) {
+                return false;
+            }
+        }
+        factored = true;
+        return true;
+    }
+
+    bool CircuitLu::refactorize(const Eigen::SparseMatrix<double>& matrix) {
+        if (!factored) {
+            return false;
+        }
+        factored = false;
+        const double* values = matrix.valuePtr();
+        for (std::size_t e = 0; e < offEntries.size(); ++e) {
+            offValues[e] = values[offEntries[e].value];
+        }
+        for (std::size_t b = 0; b + 1 < blockStart.size(); ++b) {
+            if (!refactorBlock(values, blockStart[b], blockStart[b + 1])) {
+                return false;
+            }
+        }
+        factored = true;
+        return true;
+    }
+
+    bool CircuitLu::factorBlock(const double* values, int begin, int end) {
+        for (int k = begin; k < end; ++k) {
+            pivotOf[k] = -1;
+        }
+
+        for (int j = begin; j < end; ++j) {
+            // Reach of column j in the graph of L (Gilbert-Peierls): rows its solve will touch, in postorder.
+            reach.clear();
+            for (int e = blockEntryStart[j]; e < blockEntryStart[j + 1]; ++e) {
+                const int start = blockEntries[e].row;
+                dense[start] += values[blockEntries[e].value];
+                if (visited[start] == j) {
+                    continue;
+                }
+                visited[start] = j;
+                dfsNext[start] = 0;
+                dfsStack.assign(1, start);
+                while (!dfsStack.empty()) {
+                    const int node = dfsStack.back();
+                    const int column = pivotOf[node];
+                    bool descended = false;
+                    if (column >= 0) {
+                        const std::vector<int>& rows = lower[column].rows;
+                        while (dfsNext[node] < rows.size()) {
+                            const int next = rows[dfsNext[node]++];
+                            if (visited[next] != j) {
+                                visited[next] = j;
+                                dfsNext[next] = 0;
+                                dfsStack.push_back(next);
+                                descended = true;
+                                break;
+                            }
+                        }
+                    }
+                    if (!descended) {
+                        dfsStack.pop_back();
+                        reach.push_back(node);
+                    }
+                }
+            }
+
+            // Sparse forward substitution in topological (reverse post-) order.
+            for (std::size_t t = reach.size(); t-- > 0;) {
+                const int node = reach[t];
+                const int column = pivotOf[node];
+                if (column < 0) {
+                    continue;
+                }
+                const double x = dense[node];
+                const Column& l = lower[column];
+                for (std::size_t q = 0; q < l.rows.size(); ++q) {
+                    dense[l.rows[q]] -= l.values[q] * x;
+                }
+            }
+
+            // Threshold partial pivoting: keep the diagonal unless it is much smaller than the column maximum.
+            int chosen = -1;
+            double largest = 0.0;
+            for (const int node : reach) {
+                if (pivotOf[node] < 0 && std::abs(dense[node]) > largest) {
+                    largest = std::abs(dense[node]);
+                    chosen = node;
+                }
+            }
+            if (visited[j] == j && pivotOf[j] < 0 && std::abs(dense[j]) >= pivotTolerance * largest) {
+                chosen = j;
+            }
+            // An all-zero column is numerically singular; the diagonal test above would happily take a 0 pivot.
+            if (!(largest > 0.0) || !std::isfinite(largest)) {
+                for (const int node : reach) {
+                    dense[node] = 0.0;
+                }
+                return false;
+            }
+
+            const double pivot = dense[chosen];
+            pivotOf[chosen] = j;
+            pivotRow[j] = chosen;
+            diagonal[j] = pivot;
+            Column& u = upper[j];
+            Column& l = lower[j];
+            u.rows.clear();
+            u.values.clear();
+            l.rows.clear();
+            l.values.clear();
+            for (const int node : reach) {
+                if (node != chosen) {
+                    if (pivotOf[node] >= 0) {
+                        u.rows.push_back(pivotOf[node]);
+                        u.values.push_back(dense[node]);
+                    } else {
+                        l.rows.push_back(node); // renumbered to pivot order once the block is done
+                        l.values.push_back(dense[node] / pivot);
+                    }
+                }
+                dense[node] = 0.0;
+            }
+
+            // refactorBlock() replays U in ascending pivot order.
+            std::vector<int> sorted(u.rows.size());
+            std::iota(sorted.begin(), sorted.end(), 0);
+            std::sort(sorted.begin(), sorted.end(), [&](int a, int b) { return u.rows[a] < u.rows[b]; });
+            Column ordered;
+            ordered.rows.reserve(sorted.size());
+            ordered.values.reserve(sorted.size());
+            for (const int q : sorted) {
+                ordered.rows.push_back(u.rows[q]);
+                ordered.values.push_back(u.values[q]);
+            }
+            u = std::move(ordered);
+        }
+
+        for (int j = begin; j < end; ++j) {
+            for (int& row : lower[j].rows) {
+                row = pivotOf[row];
+            }
+        }
+        return true;
+    }
+
+    bool CircuitLu::refactorBlock(const double* values, int begin, int end) {
+        for (int j = begin; j < end; ++j) {
+            for (int e = blockEntryStart[j]; e < blockEntryStart[j + 1]; ++e) {
+                dense[pivotOf[blockEntries[e].row]] += values[blockEntries[e].value];
+            }
+
+            Column& u = upper[j];
+            for (std::size_t q = 0; q < u.rows.size(); ++q) {
+                const int k = u.rows[q];
+                const double x = dense[k];
+                u.values[q] = x;
+                const Column& l = lower[k];
+                for (std::size_t r = 0; r < l.rows.size(); ++r) {
+                    dense[l.rows[r]] -= l.values[r] * x;
+                }
+            }
+
+            Column& l = lower[j];
+            const double pivot = dense[j];
+            double largest = 0.0;
+            for (const int row : l.rows) {
+                largest = std::max(largest, std::abs(dense[row]));
+            }
+            const bool usable = pivot != 0.0 && std::isfinite(pivot) && std::isfinite(largest)
+                && std::abs(pivot) >= pivotTolerance * largest;
+            for (std::size_t r = 0; r < l.rows.size(); ++r) {
+                l.values[r] = dense[l.rows[r]] / pivot;
+                dense[l.rows[r]] = 0.0;
+            }
+            for (const int k : u.rows) {
+                dense[k] = 0.0;
+            }
+            dense[j] = 0.0;
+            if (!usable) {
+                return false;
+            }
+            diagonal[j] = pivot;
+        }
+        return true;
+    }
+
+    std::size_t CircuitLu::factorNonZeros() const {
+        std::size_t total = offEntries.size() + diagonal.size();
+        for (std::size_t k = 0; k < lower.size(); ++k) {
+            total += lower[k].rows.size() + upper[k].rows.size();
+        }
+        return total;
+    }
+
+    void CircuitLu::solveColumn(const double* rhs, double* solution, std::vector<double>& permuted,
+        std::vector<double>& work) const {
+        for (int k = 0; k < size; ++k) {
+            permuted[k] = rhs[rowPermutation[k]];
+        }
+
+        // Block back substitution: solve the last diagonal block first, then push its contribution
+        // through the off-diagonal entries into the earlier blocks.
+        for (std::size_t b = blockStart.size() - 1; b-- > 0;) {
+            const int begin = blockStart[b];
+            const int end = blockStart[b + 1];
+            for (int k = begin; k < end; ++k) {
+                work[k] = permuted[pivotRow[k]];
+            }
+            for (int k = begin; k < end; ++k) {
+                const double x = work[k];
+                const Column& l = lower[k];
+                for (std::size_t q = 0; q < l.rows.size(); ++q) {
+                    work[l.rows[q]] -= l.values[q] * x;
+                }
+            }
+            for (int k = end; k-- > begin;) {
+                work[k] /= diagonal[k];
+                const double x = work[k];
+                const Column& u = upper[k];
+                for (std::size_t q = 0; q < u.rows.size(); ++q) {
+                    work[u.rows[q]] -= u.values[q] * x;
+                }
+            }
+            for (int k = begin; k < end; ++k) {
+                for (int e = offEntryStart[k]; e < offEntryStart[k + 1]; ++e) {
+                    permuted[offEntries[e].row] -= offValues[e] * work[k];
+                }
+            }
+        }
+
+        for (int k = 0; k < size; ++k) {
+            solution[columnPermutation[k]] = work[k];
+        }
+    }
+
+    void CircuitLu::solveTransposedColumn(const double* rhs, double* solution, std::vector<double>& permuted,
+        std::vector<double>& work) const {
+        // The permuted matrix P A Q is block upper triangular, so its transpose is block lower triangular:
+        // solve the first diagonal block first and pull the finished blocks in through the off-diagonal entries.
+        for (int k = 0; k < size; ++k) {
+            work[k] = rhs[columnPermutation[k]];
+        }
+        for (std::size_t b = 0; b + 1 < blockStart.size(); ++b) {
+            const int begin = blockStart[b];
+            const int end = blockStart[b + 1];
+            for (int k = begin; k < end; ++k) {
+                for (int e = offEntryStart[k]; e < offEntryStart[k + 1]; ++e) {
+                    work[k] -= offValues[e] * permuted[offEntries[e].row];
+                }
+            }
+            // Block B = Pi^T L U, so B^T y = r is U^T w = r, then L^T v = w, then y = Pi^T v.
+            for (int k = begin; k < end; ++k) {
+                const Column& u = upper[k];
+                double sum = work[k];
+                for (std::size_t q = 0; q < u.rows.size(); ++q) {
+                    sum -= u.values[q] * work[u.rows[q]];
+                }
+                work[k] = sum / diagonal[k];
+            }
+            for (int k = end; k-- > begin;) {
+                const Column& l = lower[k];
+                double sum = work[k];
+                for (std::size_t q = 0; q < l.rows.size(); ++q) {
+                    sum -= l.values[q] * work[l.rows[q]];
+                }
+                work[k] = sum;
+            }
+            for (int k = begin; k < end; ++k) {
+                permuted[pivotRow[k]] = work[k];
+            }
+        }
+
+        for (int k = 0; k < size; ++k) {
+            solution[rowPermutation[k]] = permuted[k];
+        }
+    }
+
+    Eigen::VectorXd CircuitLu::solve(const Eigen::VectorXd& rhs) const {
+        Eigen::VectorXd solution = Eigen::VectorXd::Zero(rhs.size());
+        if (!factored || rhs.size() != size) {
+            return solution;
+        }
+        std::vector<double> permuted(static_cast<std::size_t>(size));
+        std::vector<double> work(static_cast<std::size_t>(size));
+        solveColumn(rhs.data(), solution.data(), permuted, work);
+        return solution;
+    }
+
+    Eigen::MatrixXd CircuitLu::solve(const Eigen::MatrixXd& rhs) const {
+        Eigen::MatrixXd solution = Eigen::MatrixXd::Zero(rhs.rows(), rhs.cols());
+        if (!factored || rhs.rows() != size) {
+            return solution;
+        }
+        std::vector<double> permuted(static_cast<std::size_t>(size));
+        std::vector<double> work(static_cast<std::size_t>(size));
+        for (Eigen::Index c = 0; c < rhs.cols(); ++c) {
+            solveColumn(rhs.col(c).data(), solution.col(c).data(), permuted, work);
+        }
+        return solution;
+    }
+
+    Eigen::VectorXd CircuitLu::solveTransposed(const Eigen::VectorXd& rhs) const {
+        Eigen::VectorXd solution = Eigen::VectorXd::Zero(rhs.size());
+        if (!factored || rhs.size() != size) {
+            return solution;
+        }
+        std::vector<double> permuted(static_cast<std::size_t>(size));
+        std::vector<double> work(static_cast<std::size_t>(size));
+        solveTransposedColumn(rhs.data(), solution.data(), permuted, work);
+        return solution;
+    }
+}
@@ -0,0 +1,109 @@
+#ifndef CIRCUITX_CIRCUITLU_H
+#define CIRCUITX_CIRCUITLU_H
+
+#include <circuitx/circuit.hpp>
+
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+#include <cstddef>
+#include <vector>
+
+namespace circuitx {
+    template <int Width>
+    class BatchedCircuitLu;
+
+    /**
+     * Sparse LU tailored to circuit matrices (the KLU approach):
+     *
+     *  - analyze() permutes A to block upper triangular form: a maximum transversal puts nonzeros on
+     *    the diagonal, Tarjan's SCC algorithm finds the diagonal blocks, and every block larger than
+     *    2x2 gets a symmetric fill-reducing ordering (AMD, COLAMD or nested dissection, see
+     *    FillOrdering). Only the diagonal blocks are ever factored; the off-diagonal part is used
+     *    as-is during back substitution.
+     *  - factorize() runs a left-looking (Gilbert-Peierls) LU per block with threshold partial
+     *    pivoting, preferring the diagonal whenever it is within pivotTolerance of the column maximum.
+     *  - refactorize() reuses the pivot sequence and the L/U patterns of the last factorize(), so a
+     *    value-only change costs one sparse numeric pass. It fails (and the caller should factorize())
+     *    when a reused pivot no longer passes the threshold test.
+     *
+     * The matrix handed to factorize()/refactorize() must have the pattern analyze() saw.
+     */
+    class CircuitLu {
+    public:
+        static constexpr double pivotTolerance = 0.1;
+
+        // False for structurally singular matrices (no zero-free diagonal exists).
+        bool analyze(const Eigen::SparseMatrix<double>& matrix, FillOrdering ordering = FillOrdering::Automatic);
+        bool factorize(const Eigen::SparseMatrix<double>& matrix);
+        bool refactorize(const Eigen::SparseMatrix<double>& matrix);
+
+        [[nodiscard]] bool isAnalyzed() const { return analyzed; }
+        [[nodiscard]] bool isFactored() const { return factored; }
+        [[nodiscard]] std::size_t blockCount() const { return blockStart.empty() ? 0 : blockStart.size() - 1; }
+        // Entries of L and U including the diagonal, plus the untouched off-diagonal blocks.
+        [[nodiscard]] std::size_t factorNonZeros() const;
+        // Ordering applied to the largest diagonal block (Natural when every block is trivial).
+        [[nodiscard]] FillOrdering ordering() const { return usedOrdering; }
+
+        [[nodiscard]] Eigen::VectorXd solve(const Eigen::VectorXd& rhs) const;
+        [[nodiscard]] Eigen::MatrixXd solve(const Eigen::MatrixXd& rhs) const;
+        // Solves A^T x = rhs with the same factors (block forward substitution over U^T, L^T).
+        [[nodiscard]] Eigen::VectorXd solveTransposed(const Eigen::VectorXd& rhs) const;
+
+    private:
+        // Replays the symbolic analysis and the pivot sequence across several value sets at once.
+        template <int Width>
+        friend class BatchedCircuitLu;
+
+        struct Entry {
+            int value = 0; // index into the source matrix's value array
+            int row = 0;   // row in the permuted matrix
+        };
+
+        struct Column {
+            std::vector<int> rows;
+            std::vector<double> values;
+        };
+
+        bool factorBlock(const double* values, int begin, int end);
+        bool refactorBlock(const double* values, int begin, int end);
+        void solveColumn(const double* rhs, double* solution, std::vector<double>& permuted,
+            std::vector<double>& work) const;
+        void solveTransposedColumn(const double* rhs, double* solution, std::vector<double>& permuted,
+            std::vector<double>& work) const;
+
+        bool analyzed = false;
+        bool factored = false;
+        int size = 0;
+        FillOrdering usedOrdering = FillOrdering::Natural;
+        std::vector<int> rowPermutation;    // permuted row -> original row
+        std::vector<int> columnPermutation; // permuted column -> original column
+        std::vector<int> blockStart;        // diagonal block b spans [blockStart[b], blockStart[b + 1])
+        std::vector<int> blockOf;           // permuted index -> diagonal block
+
+        // Source entries of every permuted column, split into diagonal-block and off-diagonal parts.
+        std::vector<int> blockEntryStart;
+        std::vector<Entry> blockEntries;
+        std::vector<int> offEntryStart;
+        std::vector<Entry> offEntries;
+        std::vector<double> offValues;
+
+        // Per permuted column: L below the pivot (unit diagonal) and U above it, both indexed by
+        // pivot position. pivotRow[k] is the permuted row chosen as pivot k; pivotOf is its inverse.
+        std::vector<Column> lower;
+        std::vector<Column> upper;
+        std::vector<double> diagonal;
+        std::vector<int> pivotRow;
+        std::vector<int> pivotOf;
+
+        // Factorization scratch: dense accumulator and the DFS state of the sparse triangular solve.
+        std::vector<double> dense;
+        std::vector<int> visited;
+        std::vector<int> reach;
+        std::vector<int> dfsStack;
+        std::vector<std::size_t> dfsNext;
+    };
+}
+
+#endif //CIRCUITX_CIRCUITLU_H
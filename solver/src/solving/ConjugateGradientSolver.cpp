@@ -0,0 +1,140 @@
+#include "ConjugateGradientSolver.h"
+
+#include <algorithm>
+
+namespace circuitx {
+    void ConjugateGradientSolver::configure(const IterativeOptions& newOptions) {
+        if (newOptions.preconditioner != options.preconditioner) {
+            switch (newOptions.preconditioner) {
+                case PreconditionerType::Jacobi:
+                    preconditioner.emplace<JacobiPreconditioner>();
+                    break;
+                case PreconditionerType::IncompleteCholesky:
+                    preconditioner.emplace<IncompleteCholeskyPreconditioner>();
+                    break;
+                case PreconditionerType::AlgebraicMultigrid:
+                    preconditioner.emplace<AmgPreconditioner>();
+                    break;
+            }
+            analyzed = false;
+            ready = false;
+        }
+        if (!newOptions.warmStart) {
+            previous.resize(0);
+        }
+        options = newOptions;
+    }
+
+    bool ConjugateGradientSolver::setup(const SparseMatrix& newMatrix) {
+        matrix = &newMatrix;
+        const auto outerSize = static_cast<std::size_t>(newMatrix.outerSize());
+        const auto nonZeros = static_cast<std::size_t>(newMatrix.nonZeros());
+        const bool samePattern = patternOuter.size() == outerSize + 1 && patternInner.size() == nonZeros
+            && std::equal(patternOuter.begin(), patternOuter.end(), newMatrix.outerIndexPtr())
+            && std::equal(patternInner.begin(), patternInner.end(), newMatrix.innerIndexPtr());
+
+        if (!analyzed || !samePattern) {
+            patternOuter.assign(newMatrix.outerIndexPtr(), newMatrix.outerIndexPtr() + newMatrix.outerSize() + 1);
+            patternInner.assign(newMatrix.innerIndexPtr(), newMatrix.innerIndexPtr() + newMatrix.nonZeros());
+            std::visit([&](auto& p) { p.analyze(newMatrix); }, preconditioner);
+            analyzed = true;
+            ++analyzedCount;
+        }
+        ready = std::visit([&](auto& p) { return p.factorize(newMatrix); }, preconditioner);
+        return ready;
+    }
+
+    Eigen::VectorXd ConjugateGradientSolver::solve(const Eigen::VectorXd& rhs) {
+        statistics = Statistics{};
+        Eigen::VectorXd x;
+        iterate(rhs, x);
+        return x;
+    }
+
+    Eigen::VectorXd ConjugateGradientSolver::solve(const SparseMatrix& changed, const Eigen::VectorXd& rhs) {
+        const SparseMatrix* base = matrix;
+        matrix = &changed;
+        Eigen::VectorXd x = solve(rhs);
+        matrix = base;
+        return x;
+    }
+
+    Eigen::VectorXd ConjugateGradientSolver::solveDetached(const Eigen::VectorXd& rhs) {
+        Eigen::VectorXd kept;
+        kept.swap(previous);
+        Eigen::VectorXd x = solve(rhs);
+        previous.swap(kept);
+        return x;
+    }
+
+    Eigen::MatrixXd ConjugateGradientSolver::solveBlock(const Eigen::MatrixXd& rhs) {
+        statistics = Statistics{};
+        Eigen::MatrixXd solutions(rhs.rows(), rhs.cols());
+        Eigen::VectorXd x;
+        for (Eigen::Index column = 0; column < rhs.cols(); ++column) {
+            iterate(rhs.col(column), x);
+            solutions.col(column) = x;
+        }
+        return solutions;
+    }
+
+    void ConjugateGradientSolver::iterate(const Eigen::VectorXd& rhs, Eigen::VectorXd& x) {
+        const Eigen::Index n = rhs.size();
+        if (!ready || matrix == nullptr || matrix->rows() != n) {
+            x = Eigen::VectorXd::Zero(n);
+            statistics.converged = false;
+            return;
+        }
+
+        const SparseMatrix& a = *matrix;
+        const double rhsNorm = rhs.norm();
+        if (rhsNorm == 0.0) {
+            x = Eigen::VectorXd::Zero(n);
+            previous = x;
+            return;
+        }
+
+        if (options.warmStart && previous.size() == n) {
+            x = previous;
+            residual.noalias() = rhs - a * x;
+        } else {
+            x = Eigen::VectorXd::Zero(n);
+            residual = rhs;
+        }
+
+        const double threshold = options.tolerance * rhsNorm;
+        double residualNorm = residual.norm();
+        std::size_t iterations = 0;
+        if (residualNorm > threshold) {
+            std::visit([&](const auto& p) { p.apply(residual, preconditioned); }, preconditioner);
+            direction = preconditioned;
+            double rho = residual.dot(preconditioned);
+            while (iterations < static_cast<std::size_t>(std::max(options.maxIterations, 0))) {
+                product.noalias() = a * direction;
+                const double curvature = direction.dot(product);
+                // Non-positive curvature: the matrix is not SPD after all (or the search stagnated).
+                if (!(curvature > 0.0)) {
+                    break;
+                }
+                const double alpha = rho / curvature;
+                x += alpha * direction;
+                residual -= alpha * product;
+                ++iterations;
+                residualNorm = residual.norm();
+                if (residualNorm <= threshold) {
+                    break;
+                }
+                std::visit([&](const auto& p) { p.apply(residual, preconditioned); }, preconditioner);
+                const double rhoNext = residual.dot(preconditioned);
+                direction = preconditioned + (rhoNext / rho) * direction;
+                rho = rhoNext;
+            }
+        }
+
+        const double relative = residualNorm / rhsNorm;
+        statistics.iterations += iterations;
+        statistics.residual = std::max(statistics.residual, relative);
+        statistics.converged = statistics.converged && residualNorm <= threshold;
+        previous = x;
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef CIRCUITX_CONJUGATEGRADIENTSOLVER_H
+#define CIRCUITX_CONJUGATEGRADIENTSOLVER_H
+
+#include "AmgPreconditioner.h"
+#include "LinearSolver.h"
+#include "Preconditioners.h"
+
+#include <circuitx/circuit.hpp>
+
+#include <variant>
+#include <vector>
+
+namespace circuitx {
+    /**
+     * Preconditioned conjugate gradients for symmetric positive definite MNA systems, for meshes too
+     * large to factor directly. setup() builds the preconditioner for the current values (its
+     * pattern analysis is kept while the sparsity pattern stays the same); solve() iterates from the
+     * previous solution when warm starts are enabled. The matrix passed to setup() must outlive the
+     * solves that follow it.
+     */
+    class ConjugateGradientSolver {
+    public:
+        struct Statistics {
+            std::size_t iterations = 0;
+            double residual = 0.0; // ||b - Ax|| / ||b||
+            bool converged = true;
+        };
+
+        // A different preconditioner drops the current setup.
+        void configure(const IterativeOptions& options);
+        bool setup(const SparseMatrix& matrix);
+
+        [[nodiscard]] Eigen::VectorXd solve(const Eigen::VectorXd& rhs);
+        // Solves with another matrix of the same size, typically a small change of the one setup() saw,
+        // keeping the current preconditioner.
+        [[nodiscard]] Eigen::VectorXd solve(const SparseMatrix& changed, const Eigen::VectorXd& rhs);
+        // Solves an unrelated system with the same matrix (e.g. an adjoint) from a zero start; the warm start of
+        // the regular solves is left untouched.
+        [[nodiscard]] Eigen::VectorXd solveDetached(const Eigen::VectorXd& rhs);
+        // Solves the columns one after another, each starting from the previous column's solution.
+        [[nodiscard]] Eigen::MatrixXd solveBlock(const Eigen::MatrixXd& rhs);
+
+        // Summed over the columns of the last solve()/solveBlock(); residual is the worst one.
+        [[nodiscard]] const Statistics& lastStatistics() const { return statistics; }
+        [[nodiscard]] std::size_t symbolicAnalyses() const { return analyzedCount; }
+
+    private:
+        using Preconditioner = std::variant<JacobiPreconditioner, IncompleteCholeskyPreconditioner, AmgPreconditioner>;
+
+        void iterate(const Eigen::VectorXd& rhs, Eigen::VectorXd& x);
+
+        IterativeOptions options;
+        Preconditioner preconditioner{std::in_place_type<IncompleteCholeskyPreconditioner>};
+        const SparseMatrix* matrix = nullptr;
+        bool ready = false;
+        bool analyzed = false;
+        std::vector<int> patternOuter;
+        std::vector<int> patternInner;
+        Eigen::VectorXd previous;
+        Eigen::VectorXd residual;
+        Eigen::VectorXd preconditioned;
+        Eigen::VectorXd direction;
+        Eigen::VectorXd product;
+        Statistics statistics;
+        std::size_t analyzedCount = 0;
+    };
+}
+
+#endif //CIRCUITX_CONJUGATEGRADIENTSOLVER_H
@@ -0,0 +1,375 @@
+#include "FillOrdering.h"
+
+#include <Eigen/OrderingMethods>
+
+#include <algorithm>
+#include <numeric>
+
+namespace circuitx {
+    namespace {
+        // Parts at or below this size are not bisected further but ordered with AMD.
+        constexpr std::size_t dissectionLeafSize = 128;
+        // Nested dissection only beats AMD once separators are small relative to the graph.
+        constexpr int nestedDissectionMinSize = 4096;
+
+        using Permutation = Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic, int>;
+
+        // Adjacency of A + A^T without the diagonal, in compressed rows.
+        struct Graph {
+            std::vector<int> start;
+            std::vector<int> adjacent;
+
+            explicit Graph(const Eigen::SparseMatrix<double>& pattern) {
+                const auto n = static_cast<std::size_t>(pattern.rows());
+                std::vector<std::vector<int>> lists(n);
+                for (int col = 0; col < pattern.outerSize(); ++col) {
+                    for (Eigen::SparseMatrix<double>::InnerIterator it(pattern, col); it; ++it) {
+                        const int row = static_cast<int>(it.row());
+                        if (row != col) {
+                            lists[row].push_back(col);
+                            lists[col].push_back(row);
+                        }
+                    }
+                }
+                start.assign(1, 0);
+                for (auto& list : lists) {
+                    std::sort(list.begin(), list.end());
+                    list.erase(std::unique(list.begin(), list.end()), list.end());
+                    adjacent.insert(adjacent.end(), list.begin(), list.end());
+                    start.push_back(static_cast<int>(adjacent.size()));
+                }
+            }
+
+            [[nodiscard]] int degree(int node) const { return start[node + 1] - start[node]; }
+        };
+
+        // Breadth-first level structure rooted at `root`, restricted to nodes sharing its label.
+        struct LevelStructure {
+            std::vector<int> visit;      // nodes in level order
+            std::vector<int> levelStart; // level k is visit[levelStart[k], levelStart[k + 1])
+
+            [[nodiscard]] std::size_t levels() const { return levelStart.size() - 1; }
+        };
+
+        class Traversal {
+        public:
+            Traversal(const Graph& graph, std::vector<int>& label)
+                : graph(graph), label(label), mark(label.size(), -1) {}
+
+            void build(int root, LevelStructure& out) {
+                const int part = label[root];
+                ++stamp;
+                out.visit.assign(1, root);
+                out.levelStart.assign(1, 0);
+                mark[root] = stamp;
+                std::size_t begin = 0;
+                while (begin < out.visit.size()) {
+                    const std::size_t end = out.visit.size();
+                    for (std::size_t i = begin; i < end; ++i) {
+                        const int node = out.visit[i];
+                        for (int p = graph.start[node]; p < graph.start[node + 1]; ++p) {
+                            const int next = graph.adjacent[p];
+                            if (label[next] == part && mark[next] != stamp) {
+                                mark[next] = stamp;
+                                out.visit.push_back(next);
+                            }
+                        }
+                    }
+                    out.levelStart.push_back(static_cast<int>(end));
+                    begin = end;
+                }
+            }
+
+            // George-Liu: restart from a low-degree node of the last level while the depth keeps growing.
+            void pseudoPeripheral(int root, LevelStructure& out) {
+                build(root, out);
+                for (int attempt = 0; attempt < 8; ++attempt) {
+                    const std::size_t depth = out.levels();
+                    int candidate = out.visit[out.levelStart[depth - 1]];
+                    for (int i = out.levelStart[depth - 1]; i < out.levelStart[depth]; ++i) {
+                        if (graph.degree(out.visit[i]) < graph.degree(candidate)) {
+                            candidate = out.visit[i];
+                        }
+                    }
+                    LevelStructure trial;
+                    build(candidate, trial);
+                    if (trial.levels() <= depth) {
+                        break;
+                    }
+                    out = std::move(trial);
+                }
+            }
+
+        private:
+            const Graph& graph;
+            std::vector<int>& label;
+            std::vector<int> mark;
+            int stamp = 0;
+        };
+
+        std::vector<int> amdOrdering(const Eigen::SparseMatrix<double>& pattern) {
+            Eigen::AMDOrdering<int> amd;
+            Permutation permutation;
+            amd(pattern, permutation);
+            return {permutation.indices().data(), permutation.indices().data() + permutation.indices().size()};
+        }
+
+        // AMD on the subgraph induced by `nodes`; returns the nodes in elimination order.
+        std::vector<int> amdOrdering(const Graph& graph, const std::vector<int>& nodes, std::vector<int>& local) {
+            if (nodes.size() < 3) {
+                return nodes;
+            }
+            for (std::size_t t = 0; t < nodes.size(); ++t) {
+                local[nodes[t]] = static_cast<int>(t);
+            }
+            std::vector<Eigen::Triplet<double>> triplets;
+            for (std::size_t t = 0; t < nodes.size(); ++t) {
+                const int node = nodes[t];
+                triplets.emplace_back(static_cast<int>(t), static_cast<int>(t), 1.0);
+                for (int p = graph.start[node]; p < graph.start[node + 1]; ++p) {
+                    const int next = graph.adjacent[p];
+                    if (local[next] >= 0) {
+                        triplets.emplace_back(local[next], static_cast<int>(t), 1.0);
+                    }
+                }
+            }
+            for (const int node : nodes) {
+                local[node] = -1;
+            }
+            const auto size = static_cast<int>(nodes.size());
+            Eigen::SparseMatrix<double> pattern(size, size);
+            pattern.setFromTriplets(triplets.begin(), triplets.end());
+            std::vector<int> order = amdOrdering(pattern);
+            for (int& index : order) {
+                index = nodes[index];
+            }
+            return order;
+        }
+
+        // Cost of a Cholesky factorization of the graph eliminated in `order`, sum over columns of
+        // nnz(L(:, j))^2, from the elimination tree and row subtrees in O(nnz(L)). Used to compare
+        // symmetric orderings without factoring.
+        double symbolicFlops(const Graph& graph, const std::vector<int>& order) {
+            const std::size_t n = order.size();
+            std::vector<int> position(n);
+            for (std::size_t k = 0; k < n; ++k) {
+                position[order[k]] = static_cast<int>(k);
+            }
+            std::vector<int> parent(n, -1);
+            std::vector<int> ancestor(n, -1);
+            std::vector<int> mark(n, -1);
+            std::vector<double> columnCount(n, 1.0);
+            for (std::size_t k = 0; k < n; ++k) {
+                const int node = order[k];
+                const int current = static_cast<int>(k);
+                for (int p = graph.start[node]; p < graph.start[node + 1]; ++p) {
+                    int i = position[graph.adjacent[p]];
+                    while (i >= 0 && i < current) {
+                        const int next = ancestor[i];
+                        ancestor[i] = current;
+                        if (next < 0) {
+                            parent[i] = current;
+                        }
+                        i = next;
+                    }
+                }
+                mark[k] = current;
+                for (int p = graph.start[node]; p < graph.start[node + 1]; ++p) {
+                    for (int i = position[graph.adjacent[p]]; i < current && mark[i] != current; i = parent[i]) {
+                        mark[i] = current;
+                        columnCount[i] += 1.0;
+                    }
+                }
+            }
+            double flops = 0.0;
+            for (const double count : columnCount) {
+                flops += count * count;
+            }
+            return flops;
+        }
+    }
+
+    FillOrdering chooseFillOrdering(const Eigen::SparseMatrix<double>& pattern) {
+        const auto n = static_cast<int>(pattern.rows());
+        if (n < 3) {
+            return FillOrdering::Natural;
+        }
+
+        // Structural symmetry: the share of off-diagonal entries whose transpose is present too.
+        const Eigen::SparseMatrix<double> transposed = pattern.transpose();
+        std::size_t offDiagonal = 0;
+        std::size_t mirrored = 0;
+        for (int col = 0; col < n; ++col) {
+            Eigen::SparseMatrix<double>::InnerIterator a(pattern, col);
+            Eigen::SparseMatrix<double>::InnerIterator b(transposed, col);
+            while (a) {
+                if (a.row() == col) {
+                    ++a;
+                    continue;
+                }
+                ++offDiagonal;
+                while (b && b.row() < a.row()) {
+                    ++b;
+                }
+                if (b && b.row() == a.row()) {
+                    ++mirrored;
+                }
+                ++a;
+            }
+        }
+        if (offDiagonal > 0 && 2 * mirrored < offDiagonal) {
+            return FillOrdering::Colamd;
+        }
+
+        if (n >= nestedDissectionMinSize) {
+            // A k-dimensional mesh has about n^(1/k) levels; a chain-like circuit has about n.
+            const Graph graph(pattern);
+            std::vector<int> label(static_cast<std::size_t>(n), 0);
+            Traversal traversal(graph, label);
+            LevelStructure levels;
+            traversal.pseudoPeripheral(0, levels);
+            const auto depth = static_cast<double>(levels.levels());
+            if (levels.visit.size() == static_cast<std::size_t>(n) && depth * depth <= 16.0 * n) {
+                return FillOrdering::NestedDissection;
+            }
+        }
+        return FillOrdering::Amd;
+    }
+
+    std::vector<int> nestedDissection(const Eigen::SparseMatrix<double>& pattern) {
+        const auto n = static_cast<std::size_t>(pattern.rows());
+        const Graph graph(pattern);
+        // Nodes of one part share a label; separator nodes get -1 and drop out of every later traversal.
+        std::vector<int> label(n, 0);
+        std::vector<int> local(n, -1);
+        std::vector<int> levelOf(n, 0);
+        Traversal traversal(graph, label);
+        int nextLabel = 1;
+        std::vector<int> order;
+        order.reserve(n);
+
+        auto dissect = [&](auto&& self, std::vector<int> nodes) -> void {
+            if (nodes.size() <= dissectionLeafSize) {
+                const std::vector<int> leaf = amdOrdering(graph, nodes, local);
+                order.insert(order.end(), leaf.begin(), leaf.end());
+                return;
+            }
+
+            LevelStructure levels;
+            traversal.pseudoPeripheral(nodes.front(), levels);
+            if (levels.visit.size() < nodes.size()) {
+                // Disconnected part: every component is dissected on its own.
+                const int part = label[nodes.front()];
+                for (const int node : nodes) {
+                    if (label[node] != part) {
+                        continue;
+                    }
+                    LevelStructure component;
+                    traversal.build(node, component);
+                    const int componentLabel = nextLabel++;
+                    for (const int member : component.visit) {
+                        label[member] = componentLabel;
+                    }
+                    self(self, std::move(component.visit));
+                }
+                return;
+            }
+
+            const std::size_t depth = levels.levels();
+            if (depth < 3) {
+                const std::vector<int> leaf = amdOrdering(graph, nodes, local);
+                order.insert(order.end(), leaf.begin(), leaf.end());
+                return;
+            }
+
+            // Split at the level holding the median node, kept away from both ends.
+            std::size_t middle = 1;
+            while (middle + 2 < depth && static_cast<std::size_t>(levels.levelStart[middle + 1]) * 2 < nodes.size()) {
+                ++middle;
+            }
+            for (std::size_t k = 0; k < depth; ++k) {
+                for (int i = levels.levelStart[k]; i < levels.levelStart[k + 1]; ++i) {
+                    levelOf[levels.visit[i]] = static_cast<int>(k);
+                }
+            }
+
+            const int first = nextLabel++;
+            const int second = nextLabel++;
+            std::vector<int> firstPart(levels.visit.begin(), levels.visit.begin() + levels.levelStart[middle]);
+            std::vector<int> secondPart(levels.visit.begin() + levels.levelStart[middle + 1], levels.visit.end());
+            std::vector<int> separator;
+            for (int i = levels.levelStart[middle]; i < levels.levelStart[middle + 1]; ++i) {
+                // Only nodes touching the far side have to be in the separator.
+                const int node = levels.visit[i];
+                bool touchesFar = false;
+                for (int p = graph.start[node]; p < graph.start[node + 1] && !touchesFar; ++p) {
+                    const int next = graph.adjacent[p];
+                    touchesFar = label[next] == label[node] && levelOf[next] == static_cast<int>(middle) + 1;
+                }
+                (touchesFar ? separator : firstPart).push_back(node);
+            }
+            for (const int node : firstPart) {
+                label[node] = first;
+            }
+            for (const int node : secondPart) {
+                label[node] = second;
+            }
+            for (const int node : separator) {
+                label[node] = -1;
+            }
+
+            self(self, std::move(firstPart));
+            self(self, std::move(secondPart));
+            order.insert(order.end(), separator.begin(), separator.end());
+        };
+
+        std::vector<int> all(n);
+        std::iota(all.begin(), all.end(), 0);
+        dissect(dissect, std::move(all));
+        return order;
+    }
+
+    std::vector<int> computeFillOrdering(const Eigen::SparseMatrix<double>& pattern, FillOrdering ordering,
+        FillOrdering* used) {
+        FillOrdering resolved = ordering == FillOrdering::Automatic ? chooseFillOrdering(pattern) : ordering;
+        if (ordering == FillOrdering::Automatic && resolved == FillOrdering::NestedDissection) {
+            // Level-structure separators do not always beat AMD's local choices (MNA branch rows skew
+            // them), so the automatic choice keeps whichever predicts less factorization work.
+            const Graph graph(pattern);
+            std::vector<int> dissected = nestedDissection(pattern);
+            std::vector<int> minimumDegree = amdOrdering(pattern);
+            const bool dissectionWins = symbolicFlops(graph, dissected) < symbolicFlops(graph, minimumDegree);
+            if (used != nullptr) {
+                *used = dissectionWins ? FillOrdering::NestedDissection : FillOrdering::Amd;
+            }
+            return dissectionWins ? dissected : minimumDegree;
+        }
+        if (used != nullptr) {
+            *used = resolved;
+        }
+
+        switch (resolved) {
+            case FillOrdering::Amd:
+                return amdOrdering(pattern);
+            case FillOrdering::Colamd: {
+                // Unlike AMD, Eigen's COLAMD reports the new position of every old column.
+                Eigen::COLAMDOrdering<int> colamd;
+                Permutation permutation;
+                colamd(pattern, permutation);
+                std::vector<int> order(static_cast<std::size_t>(pattern.rows()));
+                for (int old = 0; old < pattern.rows(); ++old) {
+                    order[permutation.indices()[old]] = old;
+                }
+                return order;
+            }
+            case FillOrdering::NestedDissection:
+                return nestedDissection(pattern);
+            case FillOrdering::Automatic:
+            case FillOrdering::Natural:
+                break;
+        }
+        std::vector<int> identity(static_cast<std::size_t>(pattern.rows()));
+        std::iota(identity.begin(), identity.end(), 0);
+        return identity;
+    }
+}
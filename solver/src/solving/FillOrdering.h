@@ -0,0 +1,29 @@
+#ifndef CIRCUITX_FILLORDERING_H
+#define CIRCUITX_FILLORDERING_H
+
+#include <circuitx/circuit.hpp>
+
+#include <Eigen/Sparse>
+
+#include <vector>
+
+namespace circuitx {
+    /**
+     * Picks an ordering from the shape of a square pattern: COLAMD when the pattern is strongly
+     * unsymmetric, nested dissection for large mesh-like graphs (few breadth-first levels relative
+     * to their size, so small separators exist), AMD for everything else (ladders, trees, chains).
+     */
+    FillOrdering chooseFillOrdering(const Eigen::SparseMatrix<double>& pattern);
+
+    // Symmetric fill-reducing permutation of a square pattern: result[new] = old. Automatic is resolved
+    // with chooseFillOrdering(); when that suggests nested dissection, AMD is kept instead if it predicts
+    // less Cholesky work on A + A^T. The ordering actually applied is reported through `used`.
+    std::vector<int> computeFillOrdering(const Eigen::SparseMatrix<double>& pattern, FillOrdering ordering,
+        FillOrdering* used = nullptr);
+
+    // Nested dissection of the graph of A + A^T: level-structure bisection down to small parts, which
+    // are ordered with AMD; every separator is numbered after the two halves it splits.
+    std::vector<int> nestedDissection(const Eigen::SparseMatrix<double>& pattern);
+}
+
+#endif //CIRCUITX_FILLORDERING_H
@@ -0,0 +1,245 @@
+#include "LinearSolver.h"
+
+#include "FillOrdering.h"
+
+#include <algorithm>
+
+namespace circuitx {
+    bool LinearSolver::factorize(const Eigen::MatrixXd& matrix) {
+        denseSize = matrix.rows();
+        ++factorizedCount;
+        if (symmetricHint) {
+            denseLlt.compute(matrix);
+            if (denseLlt.info() == Eigen::Success) {
+                mode = Mode::DenseLlt;
+                return true;
+            }
+        }
+        denseQr.compute(matrix);
+        mode = Mode::Dense;
+        return true;
+    }
+
+    void LinearSolver::setFactorization(SparseFactorization method) {
+        if (method != factorization) {
+            factorization = method;
+            analyzed = false;
+            mode = Mode::None;
+        }
+    }
+
+    void LinearSolver::setOrdering(FillOrdering ordering) {
+        if (ordering != fillOrdering) {
+            fillOrdering = ordering;
+            analyzed = false;
+            mode = Mode::None;
+        }
+    }
+
+    void LinearSolver::setSymmetricPositiveDefinite(bool symmetric) {
+        symmetricHint = symmetric;
+    }
+
+    std::size_t LinearSolver::factorNonZeros() const {
+        switch (mode) {
+            case Mode::Dense:
+            case Mode::DenseLlt:
+                return static_cast<std::size_t>(denseSize * denseSize);
+            case Mode::CircuitLu:
+                return circuitLu.factorNonZeros();
+            case Mode::SparseLu:
+                return static_cast<std::size_t>(sparseLu.nnzL() + sparseLu.nnzU());
+            case Mode::SparseLdlt: {
+                // Only the strictly lower L is stored; count it as L + D L^T for comparison with the LUs.
+                const auto strictLower = static_cast<std::size_t>(sparseLdlt.matrixL().nestedExpression().nonZeros());
+                return 2 * strictLower + static_cast<std::size_t>(sparseLdlt.rows());
+            }
+            case Mode::SparseQr:
+                return static_cast<std::size_t>(sparseQr.matrixR().nonZeros());
+            case Mode::None:
+                break;
+        }
+        return 0;
+    }
+
+    FillOrdering LinearSolver::ordering() const {
+        switch (mode) {
+            case Mode::CircuitLu:
+                return circuitLu.ordering();
+            case Mode::SparseLdlt:
+                return ldltOrdering;
+            case Mode::SparseLu:
+            case Mode::SparseQr:
+                return FillOrdering::Colamd;
+            case Mode::Dense:
+            case Mode::DenseLlt:
+            case Mode::None:
+                break;
+        }
+        return FillOrdering::Natural;
+    }
+
+    bool LinearSolver::factorize(const SparseMatrix& matrix) {
+        if (!analyzed || !samePattern(matrix)) {
+            // Analyses are redone lazily, only for the factorizations this pattern actually reaches.
+            rememberPattern(matrix);
+            analyzed = true;
+            luAnalyzed = false;
+            ldltAnalyzed = false;
+            ++analyzedCount;
+        }
+        ++factorizedCount;
+
+        if (symmetricHint && factorizeLdlt(matrix)) {
+            mode = Mode::SparseLdlt;
+            return true;
+        }
+        if (factorizeLu(matrix)) {
+            return true;
+        }
+
+        // Singular systems (floating nodes, voltage source loops) still get a least-squares answer,
+        // mirroring what the dense QR path produces.
+        sparseQr.compute(matrix);
+        if (sparseQr.info() == Eigen::Success) {
+            mode = Mode::SparseQr;
+            return true;
+        }
+
+        mode = Mode::None;
+        return false;
+    }
+
+    bool LinearSolver::factorizeLdlt(const SparseMatrix& matrix) {
+        if (!ldltAnalyzed) {
+            const std::vector<int> order = computeFillOrdering(matrix, fillOrdering, &ldltOrdering);
+            ldltPermutation.resize(static_cast<Eigen::Index>(order.size()));
+            for (std::size_t k = 0; k < order.size(); ++k) {
+                ldltPermutation.indices()[order[k]] = static_cast<int>(k);
+            }
+        }
+        ldltMatrix.selfadjointView<Eigen::Lower>() = matrix.selfadjointView<Eigen::Lower>().twistedBy(ldltPermutation);
+        if (!ldltAnalyzed) {
+            sparseLdlt.analyzePattern(ldltMatrix);
+            ldltAnalyzed = true;
+        }
+        sparseLdlt.factorize(ldltMatrix);
+        // LDL^T also "succeeds" on many indefinite matrices without pivoting, which is not stable;
+        // anything but a strictly positive D goes to the pivoting LU instead.
+        return sparseLdlt.info() == Eigen::Success && (sparseLdlt.vectorD().array() > 0.0).all();
+    }
+
+    bool LinearSolver::factorizeLu(const SparseMatrix& matrix) {
+        if (factorization == SparseFactorization::CircuitLu) {
+            const bool freshAnalysis = !luAnalyzed;
+            if (freshAnalysis) {
+                circuitLu.analyze(matrix, fillOrdering);
+                luAnalyzed = true;
+            }
+            // A structurally singular pattern has no analysis and goes straight to QR.
+            if (!circuitLu.isAnalyzed()) {
+                return false;
+            }
+            // Same pattern as last time: replay the previous pivot sequence before pivoting afresh.
+            if (!freshAnalysis && circuitLu.refactorize(matrix)) {
+                ++pivotReuseCount;
+                mode = Mode::CircuitLu;
+                return true;
+            }
+            if (circuitLu.factorize(matrix)) {
+                mode = Mode::CircuitLu;
+                return true;
+            }
+            return false;
+        }
+
+        if (!luAnalyzed) {
+            sparseLu.analyzePattern(matrix);
+            luAnalyzed = true;
+        }
+        sparseLu.factorize(matrix);
+        if (sparseLu.info() == Eigen::Success) {
+            mode = Mode::SparseLu;
+            return true;
+        }
+        return false;
+    }
+
+    bool LinearSolver::samePattern(const SparseMatrix& matrix) const {
+        const auto outerSize = static_cast<std::size_t>(matrix.outerSize());
+        const auto nonZeros = static_cast<std::size_t>(matrix.nonZeros());
+        if (patternOuter.size() != outerSize + 1 || patternInner.size() != nonZeros) {
+            return false;
+        }
+        return std::equal(patternOuter.begin(), patternOuter.end(), matrix.outerIndexPtr()) &&
+            std::equal(patternInner.begin(), patternInner.end(), matrix.innerIndexPtr());
+    }
+
+    void LinearSolver::rememberPattern(const SparseMatrix& matrix) {
+        patternOuter.assign(matrix.outerIndexPtr(), matrix.outerIndexPtr() + matrix.outerSize() + 1);
+        patternInner.assign(matrix.innerIndexPtr(), matrix.innerIndexPtr() + matrix.nonZeros());
+    }
+
+    Eigen::VectorXd LinearSolver::solve(const Eigen::VectorXd& rhs) const {
+        switch (mode) {
+            case Mode::Dense:
+                return denseQr.solve(rhs);
+            case Mode::DenseLlt:
+                return denseLlt.solve(rhs);
+            case Mode::CircuitLu:
+                return circuitLu.solve(rhs);
+            case Mode::SparseLu:
+                return sparseLu.solve(rhs);
+            case Mode::SparseLdlt: {
+                const Eigen::VectorXd permuted = ldltPermutation * rhs;
+                return ldltPermutation.inverse() * sparseLdlt.solve(permuted);
+            }
+            case Mode::SparseQr:
+                return sparseQr.solve(rhs);
+            case Mode::None:
+                break;
+        }
+        return Eigen::VectorXd::Zero(rhs.size());
+    }
+
+    Eigen::VectorXd LinearSolver::solveTransposed(const Eigen::VectorXd& rhs) const {
+        switch (mode) {
+            case Mode::Dense:
+                return denseQr.transpose().solve(rhs);
+            case Mode::CircuitLu:
+                return circuitLu.solveTransposed(rhs);
+            case Mode::SparseLu:
+                return sparseLu.transpose().solve(rhs);
+            case Mode::DenseLlt:
+            case Mode::SparseLdlt:
+                // Cholesky-type factorizations only exist for symmetric matrices.
+                return solve(rhs);
+            case Mode::SparseQr:
+            case Mode::None:
+                break;
+        }
+        return Eigen::VectorXd::Zero(rhs.size());
+    }
+
+    Eigen::MatrixXd LinearSolver::solveBlock(const Eigen::MatrixXd& rhs) const {
+        switch (mode) {
+            case Mode::Dense:
+                return denseQr.solve(rhs);
+            case Mode::DenseLlt:
+                return denseLlt.solve(rhs);
+            case Mode::CircuitLu:
+                return circuitLu.solve(rhs);
+            case Mode::SparseLu:
+                return sparseLu.solve(rhs);
+            case Mode::SparseLdlt: {
+                const Eigen::MatrixXd permuted = ldltPermutation * rhs;
+                return ldltPermutation.inverse() * sparseLdlt.solve(permuted);
+            }
+            case Mode::SparseQr:
+                return sparseQr.solve(rhs);
+            case Mode::None:
+                break;
+        }
+        return Eigen::MatrixXd::Zero(rhs.rows(), rhs.cols());
+    }
+}
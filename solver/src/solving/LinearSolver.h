@@ -0,0 +1,95 @@
+#ifndef CIRCUITX_LINEARSOLVER_H
+#define CIRCUITX_LINEARSOLVER_H
+
+#include "CircuitLu.h"
+
+#include <circuitx/circuit.hpp>
+
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+#include <vector>
+
+namespace circuitx {
+    using SparseMatrix = Eigen::SparseMatrix<double>;
+    using Triplets = std::vector<Eigen::Triplet<double>>;
+
+    /**
+     * Factors an MNA matrix once and solves it for any number of right-hand sides.
+     * Dense systems go through column-pivoted QR, sparse systems through CircuitLu (or Eigen's
+     * SparseLU, see SparseFactorization) with a SparseQR fallback for singular matrices
+     * (e.g. floating nodes). Matrices flagged symmetric positive definite are factored with
+     * LDL^T (dense: LL^T) first and only fall back to the general path if that breaks down.
+     *
+     * The symbolic analysis (column ordering + elimination structure) of the last sparse
+     * matrix is kept; refactoring a matrix with the same sparsity pattern only redoes
+     * the numeric factorization, and CircuitLu additionally keeps its pivot sequence.
+     */
+    class LinearSolver {
+    public:
+        // Switching the sparse factorization or the ordering drops the kept symbolic analysis.
+        void setFactorization(SparseFactorization method);
+        void setOrdering(FillOrdering fillOrdering);
+        // Hint that the next matrices are symmetric positive definite (no voltage sources, positive R/C).
+        void setSymmetricPositiveDefinite(bool symmetric);
+
+        bool factorize(const Eigen::MatrixXd& matrix);
+        bool factorize(const SparseMatrix& matrix);
+
+        [[nodiscard]] Eigen::VectorXd solve(const Eigen::VectorXd& rhs) const;
+        // Solves every column of rhs against the same factorization.
+        [[nodiscard]] Eigen::MatrixXd solveBlock(const Eigen::MatrixXd& rhs) const;
+        // Solves A^T x = rhs with the same factorization. SparseQR (singular matrices) cannot: check
+        // canSolveTransposed() first.
+        [[nodiscard]] Eigen::VectorXd solveTransposed(const Eigen::VectorXd& rhs) const;
+        [[nodiscard]] bool canSolveTransposed() const { return mode != Mode::None && mode != Mode::SparseQr; }
+        [[nodiscard]] bool isSparse() const {
+            return mode == Mode::CircuitLu || mode == Mode::SparseLu || mode == Mode::SparseLdlt || mode == Mode::SparseQr;
+        }
+        // The current factorization is a Cholesky-type one (LDL^T / LL^T).
+        [[nodiscard]] bool isSymmetric() const { return mode == Mode::SparseLdlt || mode == Mode::DenseLlt; }
+        [[nodiscard]] std::size_t symbolicAnalyses() const { return analyzedCount; }
+        [[nodiscard]] std::size_t numericFactorizations() const { return factorizedCount; }
+        // CircuitLu factorizations that reused the previous pivot sequence.
+        [[nodiscard]] std::size_t pivotReuses() const { return pivotReuseCount; }
+        // Fill of the current factorization: nnz(L + U) for the LUs and LDL^T (U = D L^T), nnz(R) for
+        // SparseQR, n^2 for dense.
+        [[nodiscard]] std::size_t factorNonZeros() const;
+        [[nodiscard]] FillOrdering ordering() const;
+
+    private:
+        enum class Mode { None, Dense, DenseLlt, CircuitLu, SparseLu, SparseLdlt, SparseQr };
+
+        [[nodiscard]] bool samePattern(const SparseMatrix& matrix) const;
+        void rememberPattern(const SparseMatrix& matrix);
+        bool factorizeLdlt(const SparseMatrix& matrix);
+        bool factorizeLu(const SparseMatrix& matrix);
+
+        Mode mode = Mode::None;
+        SparseFactorization factorization = SparseFactorization::CircuitLu;
+        FillOrdering fillOrdering = FillOrdering::Automatic;
+        bool symmetricHint = false;
+        Eigen::Index denseSize = 0;
+        Eigen::ColPivHouseholderQR<Eigen::MatrixXd> denseQr;
+        Eigen::LLT<Eigen::MatrixXd> denseLlt;
+        CircuitLu circuitLu;
+        // mutable: Eigen's SparseLU::transpose() (for solveTransposed) is non-const, though it only reads the factors.
+        mutable Eigen::SparseLU<SparseMatrix, Eigen::COLAMDOrdering<int>> sparseLu;
+        Eigen::SparseQR<SparseMatrix, Eigen::COLAMDOrdering<int>> sparseQr;
+        // LDL^T runs on P A P^T with P from FillOrdering, so it honours the selected ordering.
+        Eigen::SimplicialLDLT<SparseMatrix, Eigen::Lower, Eigen::NaturalOrdering<int>> sparseLdlt;
+        Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic, int> ldltPermutation;
+        SparseMatrix ldltMatrix;
+        FillOrdering ldltOrdering = FillOrdering::Natural;
+        bool analyzed = false;
+        bool luAnalyzed = false;
+        bool ldltAnalyzed = false;
+        std::vector<int> patternOuter;
+        std::vector<int> patternInner;
+        std::size_t analyzedCount = 0;
+        std::size_t factorizedCount = 0;
+        std::size_t pivotReuseCount = 0;
+    };
+}
+
+#endif //CIRCUITX_LINEARSOLVER_H
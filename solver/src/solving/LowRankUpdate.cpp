@@ -0,0 +1,46 @@
+#include "LowRankUpdate.h"
+
+namespace circuitx {
+    namespace {
+        // Reciprocal condition estimates below this treat the small Woodbury system as singular.
+        constexpr double singularCondition = 1e-13;
+    }
+
+    Eigen::MatrixXd woodburyRhs(const Eigen::VectorXd& rhs, std::span<const RankOneUpdate> updates) {
+        const auto k = static_cast<Eigen::Index>(updates.size());
+        Eigen::MatrixXd block = Eigen::MatrixXd::Zero(rhs.size(), k + 1);
+        block.col(0) = rhs;
+        for (Eigen::Index i = 0; i < k; ++i) {
+            const StampProgram::RankOneStamp& u = updates[static_cast<std::size_t>(i)].u;
+            for (int t = 0; t < u.count; ++t) {
+                block(u.index[t], i + 1) += u.weight[t];
+            }
+        }
+        return block;
+    }
+
+    bool woodburySolution(const Eigen::MatrixXd& solved, std::span<const RankOneUpdate> updates, Eigen::VectorXd& x) {
+        const auto k = static_cast<Eigen::Index>(updates.size());
+        x = solved.col(0);
+        if (k == 0) {
+            return x.allFinite();
+        }
+
+        Eigen::MatrixXd system = Eigen::MatrixXd::Identity(k, k);
+        Eigen::VectorXd projected(k);
+        for (Eigen::Index i = 0; i < k; ++i) {
+            const RankOneUpdate& update = updates[static_cast<std::size_t>(i)];
+            for (Eigen::Index j = 0; j < k; ++j) {
+                system(i, j) += update.delta * dot(update.u, solved.col(j + 1));
+            }
+            projected(i) = update.delta * dot(update.u, x);
+        }
+
+        const Eigen::PartialPivLU<Eigen::MatrixXd> lu(system);
+        if (!(lu.rcond() > singularCondition)) {
+            return false;
+        }
+        x.noalias() -= solved.rightCols(k) * lu.solve(projected);
+        return x.allFinite();
+    }
+}
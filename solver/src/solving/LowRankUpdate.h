@@ -0,0 +1,36 @@
+#ifndef CIRCUITX_LOWRANKUPDATE_H
+#define CIRCUITX_LOWRANKUPDATE_H
+
+#include "../stamping/StampProgram.h"
+
+#include <Eigen/Dense>
+
+#include <span>
+
+namespace circuitx {
+    // One symmetric rank-1 change delta * u u^T of the DC matrix, u taken from the element's stamp.
+    struct RankOneUpdate {
+        StampProgram::RankOneStamp u;
+        double delta = 0.0;
+    };
+
+    [[nodiscard]] inline double dot(const StampProgram::RankOneStamp& u, const Eigen::Ref<const Eigen::VectorXd>& v) {
+        double sum = u.weight[0] * v(u.index[0]);
+        if (u.count == 2) {
+            sum += u.weight[1] * v(u.index[1]);
+        }
+        return sum;
+    }
+
+    /**
+     * Woodbury identity for k rank-1 changes of a matrix A that is already factored:
+     * with y = A^-1 b and Z = A^-1 U, the changed system (A + U D U^T) x = b has
+     * x = y - Z w, where (I + D U^T Z) w = D U^T y. woodburyRhs() builds [b | u_1 ... u_k] for one
+     * block solve with A; woodburySolution() turns the solved block into x and returns false when the
+     * k x k system is singular (the change made the circuit itself singular).
+     */
+    [[nodiscard]] Eigen::MatrixXd woodburyRhs(const Eigen::VectorXd& rhs, std::span<const RankOneUpdate> updates);
+    bool woodburySolution(const Eigen::MatrixXd& solved, std::span<const RankOneUpdate> updates, Eigen::VectorXd& x);
+}
+
+#endif //CIRCUITX_LOWRANKUPDATE_H
@@ -0,0 +1,30 @@
+#include "Preconditioners.h"
+
+namespace circuitx {
+    bool JacobiPreconditioner::factorize(const SparseMatrix& matrix) {
+        inverseDiagonal = matrix.diagonal();
+        for (Eigen::Index i = 0; i < inverseDiagonal.size(); ++i) {
+            // Rows nothing conducts into are left unscaled rather than divided by zero.
+            inverseDiagonal(i) = inverseDiagonal(i) > 0.0 ? 1.0 / inverseDiagonal(i) : 1.0;
+        }
+        return true;
+    }
+
+    void JacobiPreconditioner::apply(const Eigen::VectorXd& residual, Eigen::VectorXd& result) const {
+        result = inverseDiagonal.cwiseProduct(residual);
+    }
+
+    bool IncompleteCholeskyPreconditioner::analyze(const SparseMatrix& matrix) {
+        factor.analyzePattern(matrix);
+        return true;
+    }
+
+    bool IncompleteCholeskyPreconditioner::factorize(const SparseMatrix& matrix) {
+        factor.factorize(matrix);
+        return factor.info() == Eigen::Success;
+    }
+
+    void IncompleteCholeskyPreconditioner::apply(const Eigen::VectorXd& residual, Eigen::VectorXd& result) const {
+        result = factor.solve(residual);
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef CIRCUITX_PRECONDITIONERS_H
+#define CIRCUITX_PRECONDITIONERS_H
+
+#include "LinearSolver.h"
+
+#include <Eigen/IterativeLinearSolvers>
+
+namespace circuitx {
+    /**
+     * Preconditioners for ConjugateGradientSolver. Each one splits its setup into analyze() (depends
+     * on the sparsity pattern only) and factorize() (depends on the values), and apply() computes
+     * z = M^-1 r. They are held in a std::variant and dispatched with std::visit, like the stamp handlers.
+     */
+    class JacobiPreconditioner {
+    public:
+        bool analyze(const SparseMatrix&) { return true; }
+        bool factorize(const SparseMatrix& matrix);
+        void apply(const Eigen::VectorXd& residual, Eigen::VectorXd& result) const;
+
+    private:
+        Eigen::VectorXd inverseDiagonal;
+    };
+
+    // Zero fill-in incomplete LL^T in the circuit's own node order (an AMD order makes IC(0) a markedly worse
+    // approximation on meshes); Eigen shifts the diagonal if the factorization breaks down.
+    class IncompleteCholeskyPreconditioner {
+    public:
+        bool analyze(const SparseMatrix& matrix);
+        bool factorize(const SparseMatrix& matrix);
+        void apply(const Eigen::VectorXd& residual, Eigen::VectorXd& result) const;
+
+    private:
+        Eigen::IncompleteCholesky<double, Eigen::Lower, Eigen::NaturalOrdering<int>> factor;
+    };
+}
+
+#endif //CIRCUITX_PRECONDITIONERS_H
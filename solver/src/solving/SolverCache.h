@@ -0,0 +1,57 @@
+#ifndef CIRCUITX_SOLVERCACHE_H
+#define CIRCUITX_SOLVERCACHE_H
+
+#include "BlockSolver.h"
+#include "ConjugateGradientSolver.h"
+#include "LinearSolver.h"
+#include "../stamping/MnaContext.h"
+#include "../stamping/StampProgram.h"
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace circuitx {
+    // Exact description of the topology a SolverCache was built for; the hash alone may collide.
+    struct TopologySignature {
+        std::vector<unsigned int> nodeIds;
+        std::vector<std::string> nodeNames;   // ground may be picked by name
+        std::vector<std::size_t> terminals;   // element kind, a, b for every element
+    };
+
+    /**
+     * Per-topology state shared by copies of a Circuit. Everything in here depends only on which
+     * nodes exist and how elements connect them, so value edits (R, C, source levels) reuse it
+     * and only pay for a numeric refactorization.
+     */
+    struct SolverCache {
+        std::mutex mutex;
+        bool hasTopology = false;
+        std::size_t topologyHash = 0; // fast reject; a match is confirmed against topology
+        TopologySignature topology;
+        MnaContext ctx;
+        StampProgram program;
+        SparseMatrix dcSparse;
+        Eigen::MatrixXd dcDense;
+        SparseMatrix transientSparse;
+        Eigen::MatrixXd transientDense;
+        LinearSolver dcSolver;
+        BlockSolver dcBlocks;
+        SolverOptions blockOptions;  // options dcBlocks was configured with
+        bool dcUsesBlocks = false;   // the last DC factorization went to dcBlocks instead of dcSolver
+        ConjugateGradientSolver dcIterative;
+        bool dcUsesIterative = false; // the last DC solve converged with dcIterative; dcSolver is not factored
+        LinearSolver transientSolver;
+        // Coefficients and options the DC factorization holds (empty once a sweep left it at other values),
+        // so what-if solves can tell whether they may build on it.
+        std::vector<double> dcCoefficients;
+        SolverOptions dcOptions;
+        // Scratch system for what-if solves that refactor instead of updating.
+        SparseMatrix whatIfSparse;
+        Eigen::MatrixXd whatIfDense;
+        LinearSolver whatIfSolver;
+    };
+}
+
+#endif //CIRCUITX_SOLVERCACHE_H
@@ -12,26 +12,38 @@
 
 namespace circuitx {
 
+    // Equation rows of an element's terminals; -1 marks the reference node (or a wire).
+    struct ElementTerminals {
+        int a = -1;
+        int b = -1;
+    };
+
+    /**
+     * Node/voltage bookkeeping for one topology. Node IDs are compacted into dense slots once when
+     * the context is built; the stamping and transient hot paths only index the flat tables below.
+     */
     struct MnaContext {
         unsigned int groundId = 0;
         int nodeUnknowns = 0;
         int voltageUnknowns = 0;
-        std::unordered_map<unsigned int, int> nodeToIndex;
-        std::unordered_map<std::size_t, int> voltageByElement;
         std::vector<Node> nodesInContext;
         std::vector<unsigned int> indexToNodeId;
         std::vector<std::size_t> voltageIndexToElement;
 
+        std::unordered_map<unsigned int, int> slotByNodeId; // node ID -> index into nodesInContext
+        std::vector<int> equationBySlot;                    // slot -> equation row, -1 for ground
+        std::vector<ElementTerminals> terminals;            // per element
+        std::vector<int> voltageRowByElement;               // per element, -1 unless it is a VSource
+
         [[nodiscard]] int systemSize() const { return nodeUnknowns + voltageUnknowns; }
 
         [[nodiscard]] int nodeEquationIndex(unsigned int nodeId) const {
-            auto it = nodeToIndex.find(nodeId);
-            return it == nodeToIndex.end() ? -1 : it->second;
+            auto it = slotByNodeId.find(nodeId);
+            return it == slotByNodeId.end() ? -1 : equationBySlot[static_cast<std::size_t>(it->second)];
         }
 
         [[nodiscard]] int voltageEquationIndex(std::size_t elementIndex) const {
-            auto it = voltageByElement.find(elementIndex);
-            return it == voltageByElement.end() ? -1 : nodeUnknowns + it->second;
+            return elementIndex < voltageRowByElement.size() ? voltageRowByElement[elementIndex] : -1;
         }
     };
 }
@@ -4,11 +4,6 @@
 
 #include "StampContext.h"
 
-#include "handlers/ResistorStampHandler.h"
-#include "handlers/VoltageSourceStampHandler.h"
-#include "handlers/CurrentSourceStampHandler.h"
-#include "handlers/CapacitorStampHandler.h"
-
 namespace circuitx {
 
     ElementStampContext::ElementStampContext(const MnaContext& ctx,
@@ -20,55 +15,91 @@ namespace circuitx {
           rhs(rhs),
           capacitorCollector(capacitorCollector) {}
 
-    void ElementStampContext::addToMatrix(int row, int col, double value) {
-        if (!matrix || row < 0 || col < 0) {
+    ElementStampContext::ElementStampContext(const MnaContext& ctx,
+        std::vector<Eigen::Triplet<double>>* triplets,
+        Eigen::VectorXd* rhs,
+        std::vector<CapacitorState>* capacitorCollector)
+        : ctx(ctx),
+          triplets(triplets),
+          rhs(rhs),
+          capacitorCollector(capacitorCollector) {}
+
+    ElementStampContext::ElementStampContext(const MnaContext& ctx, StampRecorder* recorder)
+        : ctx(ctx),
+          recorder(recorder) {}
+
+    void ElementStampContext::stampMatrix(int row, int col, double scale) {
+        if (recorder) {
+            if (row >= 0 && col >= 0) {
+                recorder->matrix.push_back({row, col, static_cast<int>(currentElementIndex), scale});
+            }
             return;
         }
-        (*matrix)(row, col) += value;
+        addToMatrix(row, col, scale * coefficient);
     }
 
-    void ElementStampContext::addToVector(int row, double value) {
-        if (!rhs || row < 0) {
+    void ElementStampContext::stampConstant(int row, int col, double value) {
+        if (recorder) {
+            if (row >= 0 && col >= 0) {
+                recorder->matrix.push_back({row, col, -1, value});
+            }
             return;
         }
-        (*rhs)(row) += value;
+        addToMatrix(row, col, value);
     }
 
-    void ElementStampContext::setVector(int row, double value) {
-        if (!rhs || row < 0) {
+    void ElementStampContext::stampCompanion(int row, int col, double scale) {
+        if (recorder) {
+            if (row >= 0 && col >= 0) {
+                recorder->companion.push_back({row, col, static_cast<int>(currentElementIndex), scale});
+            }
             return;
         }
-        (*rhs)(row) = value;
+        if (companionScale != 0.0) {
+            addToMatrix(row, col, scale * coefficient * companionScale);
+        }
     }
 
-    void ElementStampContext::registerCapacitor(unsigned int a, unsigned int b, double capacitance) {
-        if (!capacitorCollector || capacitance <= 0.0) {
+    void ElementStampContext::stampVector(int row, double scale) {
+        if (recorder) {
+            if (row >= 0) {
+                recorder->vector.push_back({row, -1, static_cast<int>(currentElementIndex), scale});
+            }
             return;
         }
-        capacitorCollector->push_back(CapacitorState{a, b, capacitance, 0.0});
+        addToVector(row, scale * coefficient);
     }
 
-    void ElementStampRegistry::stamp(const std::vector<Element>& elements, ElementStampContext& context) const {
-        for (std::size_t idx = 0; idx < elements.size(); ++idx) {
-            context.setCurrentElementIndex(idx);
-            for (const auto& handler : handlers) {
-                if (handler->supports(elements[idx])) {
-                    handler->stamp(elements[idx], context);
-                    break;
-                }
-            }
+    void ElementStampContext::addToMatrix(int row, int col, double value) {
+        if (row < 0 || col < 0) {
+            return;
+        }
+        if (matrix) {
+            (*matrix)(row, col) += value;
+        } else if (triplets) {
+            // Duplicates are summed when the triplets are compressed into a sparse matrix.
+            triplets->emplace_back(row, col, value);
         }
     }
 
-    const ElementStampRegistry& defaultStampRegistry() {
-        static ElementStampRegistry registry = [] {
-            ElementStampRegistry reg;
-            reg.addHandler<ResistorStampHandler>();
-            reg.addHandler<VoltageSourceStampHandler>();
-            reg.addHandler<CurrentSourceStampHandler>();
-            reg.addHandler<CapacitorStampHandler>();
-            return reg;
-        }();
-        return registry;
+    void ElementStampContext::addToVector(int row, double value) {
+        if (!rhs || row < 0) {
+            return;
+        }
+        (*rhs)(row) += value;
+    }
+
+    void ElementStampContext::registerCapacitor(unsigned int a, unsigned int b, double capacitance) {
+        const auto& rows = terminals();
+        if (recorder) {
+            // Capacitance is refreshed from the program coefficients, so zero values still get a slot.
+            recorder->capacitors.push_back(CapacitorState{a, b, rows.a, rows.b, capacitance, 0.0});
+            recorder->capacitorElements.push_back(currentElementIndex);
+            return;
+        }
+        if (!capacitorCollector || capacitance <= 0.0) {
+            return;
+        }
+        capacitorCollector->push_back(CapacitorState{a, b, rows.a, rows.b, capacitance, 0.0});
     }
 }
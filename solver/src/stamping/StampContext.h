@@ -8,66 +8,89 @@
 #include "MnaContext.h"
 
 #include <Eigen/Dense>
+#include <Eigen/SparseCore>
 
-#include <memory>
 #include <vector>
 
 namespace circuitx {
     struct CapacitorState {
         unsigned int a = 0;
         unsigned int b = 0;
+        int aIdx = -1; // equation rows of the terminals, -1 for the reference node
+        int bIdx = -1;
         double capacitance = 0.0;
+        // Committed history, newest first: v(n), v(n-1), v(n-2) and the companion current i(n) (a -> b).
         double prevVoltage = 0.0;
+        double olderVoltage = 0.0;
+        double oldestVoltage = 0.0;
+        double prevCurrent = 0.0;
     };
 
+    // A stamp expressed symbolically: scale * coefficient(source element), see StampProgram.
+    struct RecordedStamp {
+        int row = -1;
+        int col = -1;
+        int source = -1; // element index, -1 for coefficient-independent entries
+        double scale = 0.0;
+    };
+
+    struct StampRecorder {
+        std::vector<RecordedStamp> matrix;
+        std::vector<RecordedStamp> companion;
+        std::vector<RecordedStamp> vector;
+        std::vector<CapacitorState> capacitors;
+        std::vector<std::size_t> capacitorElements;
+    };
+
+    /**
+     * Handlers describe their stamps relative to the element coefficient (1/R, V, I, C) provided by
+     * the registry: stampMatrix(row, col, -1) means "-coefficient at (row, col)". The context either
+     * applies them right away (dense matrix or triplets) or records them for a StampProgram.
+     */
     class ElementStampContext {
     public:
         ElementStampContext(const MnaContext& ctx,
             Eigen::MatrixXd* matrix,
             Eigen::VectorXd* rhs,
             std::vector<CapacitorState>* capacitorCollector = nullptr);
+        ElementStampContext(const MnaContext& ctx,
+            std::vector<Eigen::Triplet<double>>* triplets,
+            Eigen::VectorXd* rhs,
+            std::vector<CapacitorState>* capacitorCollector = nullptr);
+        ElementStampContext(const MnaContext& ctx, StampRecorder* recorder);
 
-        void setCurrentElementIndex(std::size_t idx) { currentElementIndex = idx; }
+        void setCurrentElement(std::size_t idx, double elementCoefficient) {
+            currentElementIndex = idx;
+            coefficient = elementCoefficient;
+        }
+        // Scale applied to companion stamps when stamping immediately (1/dt); 0 leaves them out.
+        void setCompanionScale(double scale) { companionScale = scale; }
 
-        [[nodiscard]] int nodeIndex(unsigned int nodeId) const { return ctx.nodeEquationIndex(nodeId); }
-        [[nodiscard]] int voltageIndex() const { return ctx.voltageEquationIndex(currentElementIndex); }
-        [[nodiscard]] bool hasMatrix() const { return matrix != nullptr; }
-        [[nodiscard]] bool hasVector() const { return rhs != nullptr; }
+        [[nodiscard]] const ElementTerminals& terminals() const { return ctx.terminals[currentElementIndex]; }
+        [[nodiscard]] int voltageIndex() const { return ctx.voltageRowByElement[currentElementIndex]; }
+        [[nodiscard]] bool hasMatrix() const { return matrix != nullptr || triplets != nullptr || recorder != nullptr; }
+        [[nodiscard]] bool hasVector() const { return rhs != nullptr || recorder != nullptr; }
+
+        void stampMatrix(int row, int col, double scale);
+        void stampConstant(int row, int col, double value);
+        void stampCompanion(int row, int col, double scale);
+        void stampVector(int row, double scale);
 
         void addToMatrix(int row, int col, double value);
         void addToVector(int row, double value);
-        void setVector(int row, double value);
         void registerCapacitor(unsigned int a, unsigned int b, double capacitance);
 
     private:
         const MnaContext& ctx;
-        Eigen::MatrixXd* matrix;
-        Eigen::VectorXd* rhs;
-        std::vector<CapacitorState>* capacitorCollector;
+        Eigen::MatrixXd* matrix = nullptr;
+        std::vector<Eigen::Triplet<double>>* triplets = nullptr;
+        Eigen::VectorXd* rhs = nullptr;
+        std::vector<CapacitorState>* capacitorCollector = nullptr;
+        StampRecorder* recorder = nullptr;
         std::size_t currentElementIndex = 0;
+        double coefficient = 0.0;
+        double companionScale = 0.0;
     };
-
-    class ElementStampHandler {
-    public:
-        virtual ~ElementStampHandler() = default;
-        virtual bool supports(const Element& element) const = 0;
-        virtual void stamp(const Element& element, ElementStampContext& context) const = 0;
-    };
-
-    class ElementStampRegistry {
-    public:
-        template<typename Handler, typename... Args>
-        void addHandler(Args&&... args) {
-            handlers.emplace_back(std::make_unique<Handler>(std::forward<Args>(args)...));
-        }
-
-        void stamp(const std::vector<Element>& elements, ElementStampContext& context) const;
-
-    private:
-        std::vector<std::unique_ptr<ElementStampHandler>> handlers;
-    };
-
-    const ElementStampRegistry& defaultStampRegistry();
 }
 
 #endif //CIRCUITX_STAMPCONTEXT_H
@@ -0,0 +1,285 @@
+#include "StampProgram.h"
+
+#include "StampRegistry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <tuple>
+
+namespace circuitx {
+    void StampProgram::compile(const MnaContext& ctx, const std::vector<Element>& elements, bool useSparse) {
+        StampRecorder recorder;
+        ElementStampContext context(ctx, &recorder);
+        defaultStampRegistry().stamp(elements, context);
+
+        sparse = useSparse;
+        size = ctx.systemSize();
+
+        if (sparse) {
+            std::vector<Eigen::Triplet<double>> structure;
+            structure.reserve(recorder.matrix.size() + recorder.companion.size());
+            for (const auto& stamp : recorder.matrix) {
+                structure.emplace_back(stamp.row, stamp.col, 0.0);
+            }
+            for (const auto& stamp : recorder.companion) {
+                structure.emplace_back(stamp.row, stamp.col, 0.0);
+            }
+            sparsePattern.resize(size, size);
+            sparsePattern.setFromTriplets(structure.begin(), structure.end());
+            sparsePattern.makeCompressed();
+            valueCount = static_cast<std::size_t>(sparsePattern.nonZeros());
+        } else {
+            sparsePattern.resize(0, 0);
+            valueCount = static_cast<std::size_t>(size) * static_cast<std::size_t>(size);
+        }
+
+        // The trailing coefficient is a constant 1.0 for entries that do not scale with a value.
+        coefficients.assign(elements.size() + 1, 0.0);
+        matrixOps = toInstructions(recorder.matrix);
+        companionOps = toInstructions(recorder.companion);
+        buildRankOneStamps(recorder.matrix, elements.size());
+
+        vectorOps.clear();
+        vectorOps.reserve(recorder.vector.size());
+        for (const auto& stamp : recorder.vector) {
+            const int source = stamp.source < 0 ? static_cast<int>(elements.size()) : stamp.source;
+            vectorOps.push_back({stamp.row, source, stamp.scale});
+        }
+
+        capacitorTemplate = std::move(recorder.capacitors);
+        capacitorElements = std::move(recorder.capacitorElements);
+        compiled = true;
+        refresh(elements);
+    }
+
+    std::vector<StampProgram::Instruction> StampProgram::toInstructions(const std::vector<RecordedStamp>& stamps) const {
+        const int constantSource = static_cast<int>(coefficients.size()) - 1;
+        std::vector<Instruction> ops;
+        ops.reserve(stamps.size());
+        for (const auto& stamp : stamps) {
+            int slot = 0;
+            if (sparse) {
+                const int* begin = sparsePattern.innerIndexPtr() + sparsePattern.outerIndexPtr()[stamp.col];
+                const int* end = sparsePattern.innerIndexPtr() + sparsePattern.outerIndexPtr()[stamp.col + 1];
+                slot = static_cast<int>(std::lower_bound(begin, end, stamp.row) - sparsePattern.innerIndexPtr());
+            } else {
+                slot = stamp.col * size + stamp.row;
+            }
+            ops.push_back({slot, stamp.source < 0 ? constantSource : stamp.source, stamp.scale});
+        }
+        // Slot order keeps the scatter into the value array sequential.
+        std::sort(ops.begin(), ops.end(), [](const Instruction& lhs, const Instruction& rhs) { return lhs.slot < rhs.slot; });
+        return ops;
+    }
+
+    void StampProgram::buildRankOneStamps(const std::vector<RecordedStamp>& stamps, std::size_t elementCount) {
+        rankOneStamps.assign(elementCount, RankOneStamp{});
+        std::vector<RecordedStamp> byElement;
+        byElement.reserve(stamps.size());
+        std::copy_if(stamps.begin(), stamps.end(), std::back_inserter(byElement),
+            [](const RecordedStamp& stamp) { return stamp.source >= 0; });
+        std::sort(byElement.begin(), byElement.end(), [](const RecordedStamp& lhs, const RecordedStamp& rhs) {
+            return std::tie(lhs.source, lhs.col, lhs.row) < std::tie(rhs.source, rhs.col, rhs.row);
+        });
+
+        for (std::size_t begin = 0; begin < byElement.size();) {
+            const int element = byElement[begin].source;
+            std::size_t end = begin;
+            while (end < byElement.size() && byElement[end].source == element) {
+                ++end;
+            }
+
+            // Sum repeated positions, then read u off the diagonal: u_p = sqrt(s_pp), u_q = s_pq / u_p.
+            std::array<int, 2> index{};
+            int count = 0;
+            bool fits = true;
+            double scale[2][2] = {{0.0, 0.0}, {0.0, 0.0}};
+            auto position = [&](int unknown) {
+                for (int k = 0; k < count; ++k) {
+                    if (index[k] == unknown) {
+                        return k;
+                    }
+                }
+                if (count == 2) {
+                    return -1;
+                }
+                index[count] = unknown;
+                return count++;
+            };
+            for (std::size_t i = begin; i < end && fits; ++i) {
+                const int row = position(byElement[i].row);
+                const int col = position(byElement[i].col);
+                fits = row >= 0 && col >= 0;
+                if (fits) {
+                    scale[row][col] += byElement[i].scale;
+                }
+            }
+            begin = end;
+
+            RankOneStamp& stamp = rankOneStamps[static_cast<std::size_t>(element)];
+            if (!fits || count == 0 || !(scale[0][0] > 0.0)) {
+                continue;
+            }
+            stamp.count = count;
+            stamp.index = index;
+            stamp.weight[0] = std::sqrt(scale[0][0]);
+            stamp.valid = true;
+            if (count == 2) {
+                stamp.weight[1] = scale[0][1] / stamp.weight[0];
+                const double tolerance = 1e-12 * scale[0][0];
+                stamp.valid = scale[0][1] == scale[1][0]
+                    && std::abs(scale[1][1] - stamp.weight[1] * stamp.weight[1]) <= tolerance;
+            } else {
+                stamp.index[1] = stamp.index[0];
+            }
+        }
+    }
+
+    void StampProgram::refresh(const std::vector<Element>& elements) {
+        defaultStampRegistry().coefficients(elements, coefficients);
+        coefficients.push_back(1.0);
+    }
+
+    void StampProgram::assemble(double* matrixValues, Eigen::VectorXd& rhs, double companionScale) const {
+        assembleValues(coefficients.data(), matrixValues, rhs, companionScale);
+    }
+
+    void StampProgram::assembleValues(const double* coeff, double* matrixValues, Eigen::VectorXd& rhs,
+        double companionScale) const {
+        std::fill(matrixValues, matrixValues + valueCount, 0.0);
+        rhs.setZero(size);
+
+        for (const auto& op : matrixOps) {
+            matrixValues[op.slot] += op.scale * coeff[op.source];
+        }
+        if (companionScale != 0.0) {
+            for (const auto& op : companionOps) {
+                matrixValues[op.slot] += op.scale * coeff[op.source] * companionScale;
+            }
+        }
+        for (const auto& op : vectorOps) {
+            rhs(op.slot) += op.scale * coeff[op.source];
+        }
+    }
+
+    void StampProgram::assemble(Eigen::SparseMatrix<double>& matrix, Eigen::VectorXd& rhs, double companionScale) const {
+        if (matrix.nonZeros() != sparsePattern.nonZeros() || matrix.rows() != size) {
+            matrix = sparsePattern;
+        }
+        assemble(matrix.valuePtr(), rhs, companionScale);
+    }
+
+    void StampProgram::assemble(Eigen::MatrixXd& matrix, Eigen::VectorXd& rhs, double companionScale) const {
+        matrix.resize(size, size);
+        assemble(matrix.data(), rhs, companionScale);
+    }
+
+    void StampProgram::assemble(Eigen::SparseMatrix<double>& matrix, Eigen::VectorXd& rhs,
+        std::span<const double> coefficientValues, double companionScale) const {
+        if (matrix.nonZeros() != sparsePattern.nonZeros() || matrix.rows() != size) {
+            matrix = sparsePattern;
+        }
+        assembleValues(coefficientValues.data(), matrix.valuePtr(), rhs, companionScale);
+    }
+
+    void StampProgram::assemble(Eigen::MatrixXd& matrix, Eigen::VectorXd& rhs,
+        std::span<const double> coefficientValues, double companionScale) const {
+        matrix.resize(size, size);
+        assembleValues(coefficientValues.data(), matrix.data(), rhs, companionScale);
+    }
+
+    void StampProgram::assembleRhs(Eigen::VectorXd& rhs) const {
+        rhs.setZero(size);
+        const double* coeff = coefficients.data();
+        for (const auto& op : vectorOps) {
+            rhs(op.slot) += op.scale * coeff[op.source];
+        }
+    }
+
+    void StampProgram::accumulateRhs(std::size_t element, double scale, Eigen::VectorXd& rhs) const {
+        for (const auto& op : vectorOps) {
+            if (op.source == static_cast<int>(element)) {
+                rhs(op.slot) += op.scale * scale;
+            }
+        }
+    }
+
+    bool StampProgram::scalesMatrix(std::size_t element) const {
+        return std::any_of(matrixOps.begin(), matrixOps.end(),
+            [element](const Instruction& op) { return op.source == static_cast<int>(element); });
+    }
+
+    void StampProgram::coefficientGradient(const Eigen::VectorXd& adjoint, const Eigen::VectorXd& solution,
+        std::vector<double>& gradient) const {
+        const int constantSource = static_cast<int>(coefficients.size()) - 1;
+        gradient.assign(coefficients.size() - 1, 0.0);
+        for (const auto& op : vectorOps) {
+            if (op.source != constantSource) {
+                gradient[op.source] += op.scale * adjoint(op.slot);
+            }
+        }
+        // The instructions are in slot order, so the column of a sparse slot advances monotonically.
+        int col = 0;
+        for (const auto& op : matrixOps) {
+            if (op.source == constantSource) {
+                continue;
+            }
+            int row = 0;
+            if (sparse) {
+                while (sparsePattern.outerIndexPtr()[col + 1] <= op.slot) {
+                    ++col;
+                }
+                row = sparsePattern.innerIndexPtr()[op.slot];
+            } else {
+                row = op.slot % size;
+                col = op.slot / size;
+            }
+            gradient[op.source] -= op.scale * adjoint(row) * solution(col);
+        }
+    }
+
+    std::vector<StampProgram::MatrixEntry> StampProgram::matrixEntries() const {
+        std::vector<int> slots;
+        slots.reserve(matrixOps.size() + companionOps.size());
+        for (const auto& op : matrixOps) {
+            slots.push_back(op.slot);
+        }
+        for (const auto& op : companionOps) {
+            slots.push_back(op.slot);
+        }
+        std::sort(slots.begin(), slots.end());
+        slots.erase(std::unique(slots.begin(), slots.end()), slots.end());
+
+        std::vector<MatrixEntry> entries;
+        entries.reserve(slots.size());
+        for (int slot : slots) {
+            if (sparse) {
+                const int* outerBegin = sparsePattern.outerIndexPtr();
+                const int* outerEnd = outerBegin + sparsePattern.outerSize() + 1;
+                const int col = static_cast<int>(std::upper_bound(outerBegin, outerEnd, slot) - outerBegin) - 1;
+                entries.push_back({slot, sparsePattern.innerIndexPtr()[slot], col});
+            } else {
+                entries.push_back({slot, slot % size, slot / size});
+            }
+        }
+        return entries;
+    }
+
+    std::vector<CapacitorState> StampProgram::capacitors() const {
+        return capacitors(coefficients);
+    }
+
+    std::vector<CapacitorState> StampProgram::capacitors(std::span<const double> coefficientValues) const {
+        std::vector<CapacitorState> states;
+        states.reserve(capacitorTemplate.size());
+        for (std::size_t i = 0; i < capacitorTemplate.size(); ++i) {
+            CapacitorState state = capacitorTemplate[i];
+            state.capacitance = coefficientValues[capacitorElements[i]];
+            if (state.capacitance > 0.0) {
+                states.push_back(state);
+            }
+        }
+        return states;
+    }
+}
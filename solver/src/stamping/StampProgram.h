@@ -0,0 +1,109 @@
+#ifndef CIRCUITX_STAMPPROGRAM_H
+#define CIRCUITX_STAMPPROGRAM_H
+
+#include "StampContext.h"
+
+#include <Eigen/SparseCore>
+
+#include <array>
+#include <span>
+#include <vector>
+
+namespace circuitx {
+    /**
+     * The element list compiled into flat stamp instructions for one topology. Each instruction is a
+     * target slot (index into the sparse value array, or the column-major dense storage) plus the
+     * element whose coefficient it scales. Re-assembly after a value edit or per timestep is a
+     * linear pass over the instructions with no variant inspection and no index lookups.
+     */
+    class StampProgram {
+    public:
+        // A structurally nonzero matrix position and its slot in the value array.
+        struct MatrixEntry {
+            int slot = 0;
+            int row = 0;
+            int col = 0;
+        };
+
+        // The DC matrix stamp of one element written as coefficient * u u^T, with
+        // u = weight[0] e_index[0] + weight[1] e_index[1] (a conductance between a and b gives e_a - e_b,
+        // a grounded terminal drops out). Value changes of such elements are rank-1 matrix updates.
+        struct RankOneStamp {
+            bool valid = false; // the element stamps the DC matrix and the stamp has this form
+            int count = 0;      // unknowns in u
+            std::array<int, 2> index{};
+            std::array<double, 2> weight{};
+        };
+
+        void compile(const MnaContext& ctx, const std::vector<Element>& elements, bool sparse);
+        // Reloads element coefficients after values changed; the instructions stay valid.
+        void refresh(const std::vector<Element>& elements);
+
+        // companionScale multiplies the capacitor companion stamps (1/dt), 0 assembles the DC matrix.
+        void assemble(double* matrixValues, Eigen::VectorXd& rhs, double companionScale = 0.0) const;
+        void assemble(Eigen::SparseMatrix<double>& matrix, Eigen::VectorXd& rhs, double companionScale = 0.0) const;
+        void assemble(Eigen::MatrixXd& matrix, Eigen::VectorXd& rhs, double companionScale = 0.0) const;
+        // Same, with caller-owned coefficients (laid out like elementCoefficients()) instead of the program's.
+        void assemble(Eigen::SparseMatrix<double>& matrix, Eigen::VectorXd& rhs,
+            std::span<const double> coefficientValues, double companionScale = 0.0) const;
+        void assemble(Eigen::MatrixXd& matrix, Eigen::VectorXd& rhs,
+            std::span<const double> coefficientValues, double companionScale = 0.0) const;
+        void assembleRhs(Eigen::VectorXd& rhs) const;
+
+        // Adds scale * (right-hand side produced by a unit coefficient of `element`) to rhs.
+        void accumulateRhs(std::size_t element, double scale, Eigen::VectorXd& rhs) const;
+        [[nodiscard]] bool scalesMatrix(std::size_t element) const;
+        // Adjoint sensitivities of the DC system A x = b: gradient[e] = adjoint^T (db/dc_e - dA/dc_e x) is the
+        // derivative of adjoint^T x (with adjoint = A^-T output) by element e's coefficient, for every element.
+        // One pass over the instructions.
+        void coefficientGradient(const Eigen::VectorXd& adjoint, const Eigen::VectorXd& solution,
+            std::vector<double>& gradient) const;
+        // Overrides one coefficient until the next refresh(), e.g. for parameter sweeps.
+        void setCoefficient(std::size_t element, double coefficient) { coefficients[element] = coefficient; }
+
+        [[nodiscard]] bool isCompiled() const { return compiled; }
+        [[nodiscard]] bool isSparse() const { return sparse; }
+        [[nodiscard]] int systemSize() const { return size; }
+        // Compressed matrix holding the sparsity pattern (values are zero).
+        [[nodiscard]] const Eigen::SparseMatrix<double>& pattern() const { return sparsePattern; }
+        [[nodiscard]] std::vector<CapacitorState> capacitors() const;
+        // Same, with capacitances read from caller-owned coefficients.
+        [[nodiscard]] std::vector<CapacitorState> capacitors(std::span<const double> coefficientValues) const;
+        // Every capacitor in stamp order, zero-valued ones included; capacitances are left unset. Entry i belongs
+        // to element capacitorElementIndices()[i].
+        [[nodiscard]] const std::vector<CapacitorState>& capacitorTemplates() const { return capacitorTemplate; }
+        [[nodiscard]] const std::vector<std::size_t>& capacitorElementIndices() const { return capacitorElements; }
+        // Every slot written by the DC or companion stamps, in slot order.
+        [[nodiscard]] std::vector<MatrixEntry> matrixEntries() const;
+        // Size of the value array assemble(double*, ...) writes.
+        [[nodiscard]] std::size_t valueSlots() const { return valueCount; }
+        [[nodiscard]] const std::vector<double>& elementCoefficients() const { return coefficients; }
+        [[nodiscard]] const RankOneStamp& rankOneStamp(std::size_t element) const { return rankOneStamps[element]; }
+
+    private:
+        struct Instruction {
+            int slot = 0;
+            int source = 0; // index into coefficients; the last entry is the constant 1.0
+            double scale = 0.0;
+        };
+
+        void assembleValues(const double* coeff, double* matrixValues, Eigen::VectorXd& rhs, double companionScale) const;
+        std::vector<Instruction> toInstructions(const std::vector<RecordedStamp>& stamps) const;
+        void buildRankOneStamps(const std::vector<RecordedStamp>& stamps, std::size_t elementCount);
+
+        bool compiled = false;
+        bool sparse = false;
+        int size = 0;
+        std::size_t valueCount = 0;
+        Eigen::SparseMatrix<double> sparsePattern;
+        std::vector<Instruction> matrixOps;
+        std::vector<Instruction> companionOps;
+        std::vector<Instruction> vectorOps;
+        std::vector<double> coefficients;
+        std::vector<RankOneStamp> rankOneStamps;
+        std::vector<CapacitorState> capacitorTemplate;
+        std::vector<std::size_t> capacitorElements;
+    };
+}
+
+#endif //CIRCUITX_STAMPPROGRAM_H
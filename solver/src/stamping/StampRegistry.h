@@ -0,0 +1,104 @@
+#ifndef CIRCUITX_STAMPREGISTRY_H
+#define CIRCUITX_STAMPREGISTRY_H
+
+#include "StampContext.h"
+
+#include "handlers/ResistorStampHandler.h"
+#include "handlers/VoltageSourceStampHandler.h"
+#include "handlers/CurrentSourceStampHandler.h"
+#include "handlers/CapacitorStampHandler.h"
+
+#include <tuple>
+#include <type_traits>
+#include <variant>
+
+namespace circuitx {
+    /**
+     * Dispatches every element to the handler whose ElementType matches its variant alternative.
+     * The handler is picked at compile time by std::visit, so stamping does no per-element handler
+     * scan and no virtual calls. Wires have no handler: they are merged into supernodes beforehand.
+     */
+    template<typename... Handlers>
+    class ElementStampRegistry {
+    public:
+        void stamp(const std::vector<Element>& elements, ElementStampContext& context) const {
+            for (std::size_t idx = 0; idx < elements.size(); ++idx) {
+                std::visit(
+                    [&](const auto& component) {
+                        context.setCurrentElement(idx, coefficientOf(component));
+                        stampWith(component, context);
+                    },
+                    elements[idx]);
+            }
+        }
+
+        // Per-element stamp coefficients (1/R, V, I, C), indexed like `elements`.
+        void coefficients(const std::vector<Element>& elements, std::vector<double>& out) const {
+            out.resize(elements.size());
+            for (std::size_t idx = 0; idx < elements.size(); ++idx) {
+                out[idx] = coefficient(elements[idx]);
+            }
+        }
+
+        [[nodiscard]] static double coefficient(const Element& element) {
+            return std::visit([](const auto& component) { return coefficientOf(component); }, element);
+        }
+
+    private:
+        template<typename T>
+        static constexpr bool handles = (std::is_same_v<typename Handlers::ElementType, T> || ...);
+
+        template<typename T>
+        static double coefficientOf(const T& component) {
+            if constexpr (handles<T>) {
+                return HandlerFor<T, Handlers...>::coefficient(component);
+            } else {
+                return 0.0;
+            }
+        }
+
+        template<typename T>
+        void stampWith(const T& component, ElementStampContext& context) const {
+            if constexpr (handles<T>) {
+                handlerFor<T, Handlers...>().stamp(component, context);
+            } else {
+                static_assert(std::is_same_v<T, Wire>, "No stamp handler registered for this element type");
+            }
+        }
+
+        template<typename T, typename Head, typename... Tail>
+        struct HandlerForImpl {
+            using type = std::conditional_t<std::is_same_v<typename Head::ElementType, T>,
+                Head,
+                typename HandlerForImpl<T, Tail...>::type>;
+        };
+
+        template<typename T, typename Head>
+        struct HandlerForImpl<T, Head> {
+            using type = Head;
+        };
+
+        template<typename T, typename... Hs>
+        using HandlerFor = typename HandlerForImpl<T, Hs...>::type;
+
+        template<typename T, typename... Hs>
+        const auto& handlerFor() const {
+            return std::get<HandlerFor<T, Hs...>>(handlers);
+        }
+
+        std::tuple<Handlers...> handlers;
+    };
+
+    // Register new element handlers here.
+    using DefaultStampRegistry = ElementStampRegistry<ResistorStampHandler,
+        VoltageSourceStampHandler,
+        CurrentSourceStampHandler,
+        CapacitorStampHandler>;
+
+    inline const DefaultStampRegistry& defaultStampRegistry() {
+        static const DefaultStampRegistry registry;
+        return registry;
+    }
+}
+
+#endif //CIRCUITX_STAMPREGISTRY_H
@@ -5,12 +5,20 @@
 #include "CapacitorStampHandler.h"
 
 namespace circuitx {
-    bool CapacitorStampHandler::supports(const Element& element) const {
-        return std::holds_alternative<Cap>(element);
-    }
+    void CapacitorStampHandler::stamp(const Cap& cap, ElementStampContext& context) const {
+        context.registerCapacitor(cap.a, cap.b, coefficient(cap));
 
-    void CapacitorStampHandler::stamp(const Element& element, ElementStampContext& context) const {
-        const auto& cap = std::get<Cap>(element);
-        context.registerCapacitor(cap.a, cap.b, static_cast<double>(cap.cap));
+        // Companion conductance C/dt; only present when stamping a transient matrix.
+        const auto [aIdx, bIdx] = context.terminals();
+        if (aIdx >= 0) {
+            context.stampCompanion(aIdx, aIdx, 1.0);
+        }
+        if (bIdx >= 0) {
+            context.stampCompanion(bIdx, bIdx, 1.0);
+        }
+        if (aIdx >= 0 && bIdx >= 0) {
+            context.stampCompanion(aIdx, bIdx, -1.0);
+            context.stampCompanion(bIdx, aIdx, -1.0);
+        }
     }
 }
@@ -8,10 +8,13 @@
 #include "../StampContext.h"
 
 namespace circuitx {
-    class CapacitorStampHandler : public ElementStampHandler {
+    class CapacitorStampHandler {
     public:
-        bool supports(const Element& element) const override;
-        void stamp(const Element& element, ElementStampContext& context) const override;
+        using ElementType = Cap;
+
+        static double coefficient(const Cap& cap) { return static_cast<double>(cap.cap); }
+
+        void stamp(const Cap& cap, ElementStampContext& context) const;
     };
 }
 
@@ -8,10 +8,13 @@
 #include "../StampContext.h"
 
 namespace circuitx {
-    class CurrentSourceStampHandler : public ElementStampHandler {
+    class CurrentSourceStampHandler {
     public:
-        bool supports(const Element& element) const override;
-        void stamp(const Element& element, ElementStampContext& context) const override;
+        using ElementType = ISource;
+
+        static double coefficient(const ISource& src) { return static_cast<double>(src.cur); }
+
+        void stamp(const ISource& src, ElementStampContext& context) const;
     };
 }
 
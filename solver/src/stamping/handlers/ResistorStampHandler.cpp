@@ -5,32 +5,23 @@
 #include "ResistorStampHandler.h"
 
 namespace circuitx {
-    bool ResistorStampHandler::supports(const Element& element) const {
-        return std::holds_alternative<Res>(element);
-    }
-
-    void ResistorStampHandler::stamp(const Element& element, ElementStampContext& context) const {
+    void ResistorStampHandler::stamp(const Res&, ElementStampContext& context) const {
         if (!context.hasMatrix()) {
             return;
         }
-        const auto& res = std::get<Res>(element);
-        if (res.res <= 0.f) {
-            return;
-        }
-
-        const double conductance = 1.0 / static_cast<double>(res.res);
-        const int aIdx = context.nodeIndex(res.a);
-        const int bIdx = context.nodeIndex(res.b);
+        // Non-positive resistances get a zero conductance (see coefficient()) but keep their
+        // entries, so the sparsity pattern does not depend on the value.
+        const auto [aIdx, bIdx] = context.terminals();
 
         if (aIdx >= 0) {
-            context.addToMatrix(aIdx, aIdx, conductance);
+            context.stampMatrix(aIdx, aIdx, 1.0);
         }
         if (bIdx >= 0) {
-            context.addToMatrix(bIdx, bIdx, conductance);
+            context.stampMatrix(bIdx, bIdx, 1.0);
         }
         if (aIdx >= 0 && bIdx >= 0) {
-            context.addToMatrix(aIdx, bIdx, -conductance);
-            context.addToMatrix(bIdx, aIdx, -conductance);
+            context.stampMatrix(aIdx, bIdx, -1.0);
+            context.stampMatrix(bIdx, aIdx, -1.0);
         }
     }
 }
@@ -8,10 +8,13 @@
 #include "../StampContext.h"
 
 namespace circuitx {
-    class ResistorStampHandler : public ElementStampHandler {
+    class ResistorStampHandler {
     public:
-        bool supports(const Element& element) const override;
-        void stamp(const Element& element, ElementStampContext& context) const override;
+        using ElementType = Res;
+
+        static double coefficient(const Res& res) { return res.res > 0.f ? 1.0 / static_cast<double>(res.res) : 0.0; }
+
+        void stamp(const Res& res, ElementStampContext& context) const;
     };
 }
 
@@ -5,32 +5,26 @@
 #include "VoltageSourceStampHandler.h"
 
 namespace circuitx {
-    bool VoltageSourceStampHandler::supports(const Element& element) const {
-        return std::holds_alternative<VSource>(element);
-    }
-
-    void VoltageSourceStampHandler::stamp(const Element& element, ElementStampContext& context) const {
-        const auto& src = std::get<VSource>(element);
+    void VoltageSourceStampHandler::stamp(const VSource&, ElementStampContext& context) const {
         const int eqIdx = context.voltageIndex();
         if (eqIdx < 0) {
             return;
         }
-        const int aIdx = context.nodeIndex(src.a);
-        const int bIdx = context.nodeIndex(src.b);
+        const auto [aIdx, bIdx] = context.terminals();
 
         if (context.hasMatrix()) {
             if (aIdx >= 0) {
-                context.addToMatrix(aIdx, eqIdx, 1.0);
-                context.addToMatrix(eqIdx, aIdx, 1.0);
+                context.stampConstant(aIdx, eqIdx, 1.0);
+                context.stampConstant(eqIdx, aIdx, 1.0);
             }
             if (bIdx >= 0) {
-                context.addToMatrix(bIdx, eqIdx, -1.0);
-                context.addToMatrix(eqIdx, bIdx, -1.0);
+                context.stampConstant(bIdx, eqIdx, -1.0);
+                context.stampConstant(eqIdx, bIdx, -1.0);
             }
         }
 
         if (context.hasVector()) {
-            context.setVector(eqIdx, static_cast<double>(src.vol));
+            context.stampVector(eqIdx, 1.0);
         }
     }
 }
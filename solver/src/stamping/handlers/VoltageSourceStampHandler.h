@@ -8,10 +8,13 @@
 #include "../StampContext.h"
 
 namespace circuitx {
-    class VoltageSourceStampHandler : public ElementStampHandler {
+    class VoltageSourceStampHandler {
     public:
-        bool supports(const Element& element) const override;
-        void stamp(const Element& element, ElementStampContext& context) const override;
+        using ElementType = VSource;
+
+        static double coefficient(const VSource& src) { return static_cast<double>(src.vol); }
+
+        void stamp(const VSource& src, ElementStampContext& context) const;
     };
 }
 
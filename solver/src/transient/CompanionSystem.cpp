@@ -0,0 +1,155 @@
+#include "CompanionSystem.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace circuitx {
+    namespace {
+        double voltageAtRow(int row, const Eigen::VectorXd& solution) {
+            return row >= 0 && row < solution.size() ? solution(row) : 0.0;
+        }
+
+        double capacitorVoltage(const CapacitorState& cap, const Eigen::VectorXd& solution) {
+            return voltageAtRow(cap.aIdx, solution) - voltageAtRow(cap.bIdx, solution);
+        }
+    }
+
+    CompanionCoefficients companionCoefficients(IntegrationMethod method, double step, double lastStep) {
+        switch (method) {
+            case IntegrationMethod::Trapezoidal:
+                return {2.0 / step, -2.0 / step, 0.0};
+            case IntegrationMethod::Gear2:
+                if (lastStep > 0.0) {
+                    // Variable-step BDF2, omega = h(n+1) / h(n).
+                    const double omega = step / lastStep;
+                    return {(1.0 + 2.0 * omega) / ((1.0 + omega) * step),
+                        -(1.0 + omega) / step,
+                        omega * omega / ((1.0 + omega) * step)};
+                }
+                break;
+            case IntegrationMethod::BackwardEuler:
+                break;
+        }
+        return {1.0 / step, -1.0 / step, 0.0};
+    }
+
+    CompanionSystem::CompanionSystem(const StampProgram& program, LinearSolver& solver,
+        SparseMatrix& sparseStorage, Eigen::MatrixXd& denseStorage, IntegrationMethod method,
+        std::span<const double> coefficients)
+        : program(program),
+          elementValues(coefficients.empty() ? std::span<const double>(program.elementCoefficients()) : coefficients),
+          solver(solver),
+          sparseStorage(sparseStorage),
+          denseStorage(denseStorage),
+          method(method),
+          capacitors(program.capacitors(elementValues)),
+          z(Eigen::VectorXd::Zero(program.systemSize())) {}
+
+    void CompanionSystem::seed(const Eigen::VectorXd& solution) {
+        // The seed is a DC operating point, so no current flows through the capacitors.
+        for (auto& cap : capacitors) {
+            cap.prevVoltage = capacitorVoltage(cap, solution);
+            cap.olderVoltage = cap.prevVoltage;
+            cap.oldestVoltage = cap.prevVoltage;
+            cap.prevCurrent = 0.0;
+        }
+        candidate = solution;
+        lastStep = 0.0;
+        olderStep = 0.0;
+    }
+
+    void CompanionSystem::factorize(double scale) {
+        if (program.isSparse()) {
+            program.assemble(sparseStorage, baseZ, elementValues, scale);
+            solver.factorize(sparseStorage);
+        } else {
+            program.assemble(denseStorage, baseZ, elementValues, scale);
+            solver.factorize(denseStorage);
+        }
+        factoredScale = scale;
+        ++factorCount;
+    }
+
+    const Eigen::VectorXd& CompanionSystem::advance(double step) {
+        const CompanionCoefficients coefficients = companionCoefficients(method, step, lastStep);
+        if (coefficients.a0 != factoredScale) {
+            factorize(coefficients.a0);
+        }
+
+        const bool trapezoidal = method == IntegrationMethod::Trapezoidal;
+        z = baseZ;
+        for (const auto& cap : capacitors) {
+            double historyCurrent = -cap.capacitance * (coefficients.a1 * cap.prevVoltage + coefficients.a2 * cap.olderVoltage);
+            if (trapezoidal) {
+                historyCurrent += cap.prevCurrent;
+            }
+            if (cap.aIdx >= 0) {
+                z(cap.aIdx) += historyCurrent;
+            }
+            if (cap.bIdx >= 0) {
+                z(cap.bIdx) -= historyCurrent;
+            }
+        }
+
+        candidate = solver.solve(z);
+        candidateCoefficients = coefficients;
+        candidateStep = step;
+        return candidate;
+    }
+
+    void CompanionSystem::commit() {
+        const CompanionCoefficients& c = candidateCoefficients;
+        const bool trapezoidal = method == IntegrationMethod::Trapezoidal;
+        for (auto& cap : capacitors) {
+            const double next = capacitorVoltage(cap, candidate);
+            double current = cap.capacitance * (c.a0 * next + c.a1 * cap.prevVoltage + c.a2 * cap.olderVoltage);
+            if (trapezoidal) {
+                current -= cap.prevCurrent;
+            }
+            cap.oldestVoltage = cap.olderVoltage;
+            cap.olderVoltage = cap.prevVoltage;
+            cap.prevVoltage = next;
+            cap.prevCurrent = current;
+        }
+        olderStep = lastStep;
+        lastStep = candidateStep;
+    }
+
+    double CompanionSystem::localError(double next, const CapacitorState& cap) const {
+        const double h = candidateStep;
+        // Divided differences over the candidate and the committed points.
+        const double d1New = (next - cap.prevVoltage) / h;
+        const double d1Old = (cap.prevVoltage - cap.olderVoltage) / lastStep;
+        const double d2New = (d1New - d1Old) / (h + lastStep);
+        if (method == IntegrationMethod::BackwardEuler) {
+            // h^2/2 * v''
+            return h * h * std::abs(d2New);
+        }
+
+        const double d1Oldest = (cap.olderVoltage - cap.oldestVoltage) / olderStep;
+        const double d2Old = (d1Old - d1Oldest) / (lastStep + olderStep);
+        const double d3 = (d2New - d2Old) / (h + lastStep + olderStep); // v''' / 6
+        if (method == IntegrationMethod::Trapezoidal) {
+            // h^3/12 * v'''
+            return 0.5 * h * h * h * std::abs(d3);
+        }
+        // Variable-step BDF2; reduces to 2/9 * h^3 * v''' for equal steps.
+        const double span = h + lastStep;
+        return span * span * h * h / (2.0 * h + lastStep) * std::abs(d3);
+    }
+
+    double CompanionSystem::errorRatio(double relativeTolerance, double absoluteTolerance) const {
+        if (lastStep <= 0.0 || (order() > 1 && olderStep <= 0.0)) {
+            return 0.0;
+        }
+
+        double worst = 0.0;
+        for (const auto& cap : capacitors) {
+            const double next = capacitorVoltage(cap, candidate);
+            const double tolerance = absoluteTolerance
+                + relativeTolerance * std::max(std::abs(next), std::abs(cap.prevVoltage));
+            worst = std::max(worst, localError(next, cap) / tolerance);
+        }
+        return worst;
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef CIRCUITX_COMPANIONSYSTEM_H
+#define CIRCUITX_COMPANIONSYSTEM_H
+
+#include "../solving/LinearSolver.h"
+#include "../stamping/StampProgram.h"
+
+#include <circuitx/transient.hpp>
+
+#include <span>
+#include <vector>
+
+namespace circuitx {
+    // v(n+1) derivative coefficients: dv/dt ~ a0 v(n+1) + a1 v(n) + a2 v(n-1).
+    struct CompanionCoefficients {
+        double a0 = 0.0;
+        double a1 = 0.0;
+        double a2 = 0.0;
+    };
+
+    // Coefficients of a step of `step` seconds; lastStep produced v(n) and is 0 right after the DC seed.
+    [[nodiscard]] CompanionCoefficients companionCoefficients(IntegrationMethod method, double step, double lastStep);
+
+    /**
+     * The transient MNA system with capacitors replaced by the companion model of the selected
+     * integration method (geq = C * a0, plus a history current source).
+     * advance() solves for a candidate next point without touching the history, so the caller can
+     * reject it and retry with a smaller step; commit() makes the candidate the new history point.
+     * The matrix is only re-assembled and refactored when the companion scale a0 changes.
+     * Element values come from the program, or from caller-owned coefficients (laid out like
+     * StampProgram::elementCoefficients()) that must outlive the system.
+     */
+    class CompanionSystem {
+    public:
+        CompanionSystem(const StampProgram& program, LinearSolver& solver,
+            SparseMatrix& sparseStorage, Eigen::MatrixXd& denseStorage, IntegrationMethod method,
+            std::span<const double> coefficients = {});
+
+        void seed(const Eigen::VectorXd& solution);
+        const Eigen::VectorXd& advance(double step);
+        void commit();
+
+        // Largest capacitor LTE of the candidate relative to its tolerance; 0 until enough points are committed.
+        [[nodiscard]] double errorRatio(double relativeTolerance, double absoluteTolerance) const;
+        [[nodiscard]] int order() const { return method == IntegrationMethod::BackwardEuler ? 1 : 2; }
+        [[nodiscard]] std::size_t factorizations() const { return factorCount; }
+
+    private:
+        [[nodiscard]] double localError(double next, const CapacitorState& cap) const;
+        void factorize(double scale);
+
+        const StampProgram& program;
+        std::span<const double> elementValues;
+        LinearSolver& solver;
+        SparseMatrix& sparseStorage;
+        Eigen::MatrixXd& denseStorage;
+        IntegrationMethod method;
+        std::vector<CapacitorState> capacitors;
+        Eigen::VectorXd baseZ;
+        Eigen::VectorXd z;
+        Eigen::VectorXd candidate;
+        CompanionCoefficients candidateCoefficients;
+        double factoredScale = 0.0;
+        double candidateStep = 0.0;
+        double lastStep = 0.0;  // step that produced the committed point, 0 right after seed()
+        double olderStep = 0.0; // the step before that
+        std::size_t factorCount = 0;
+    };
+}
+
+#endif //CIRCUITX_COMPANIONSYSTEM_H
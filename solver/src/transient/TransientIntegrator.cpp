@@ -0,0 +1,119 @@
+#include "TransientIntegrator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace circuitx {
+    namespace {
+        std::int64_t totalSteps(const TransientOptions& options) {
+            return static_cast<std::int64_t>(std::ceil(options.durationSeconds / options.timestepSeconds));
+        }
+    }
+
+    bool validTransientOptions(const TransientOptions& options) {
+        if (options.durationSeconds <= 0.0 || options.timestepSeconds <= 0.0) {
+            return false;
+        }
+        return !options.adaptive || (options.relativeTolerance > 0.0 && options.absoluteTolerance > 0.0);
+    }
+
+    std::size_t transientSampleCount(const TransientOptions& options) {
+        return static_cast<std::size_t>(totalSteps(options)) + 1;
+    }
+
+    TransientStatistics integrateTransient(CompanionSystem& system,
+        const Eigen::VectorXd& steadyState,
+        const TransientOptions& options,
+        std::size_t columns,
+        TransientSink& sink) {
+        TransientStatistics statistics;
+        const double durationSeconds = options.durationSeconds;
+        const double timestepSeconds = options.timestepSeconds;
+        const std::int64_t steps = totalSteps(options);
+
+        // One reusable row: node unknowns occupy the leading rows of the solution, ground is last.
+        const std::size_t nodeUnknowns = columns - 1;
+        std::vector<double> row(columns, 0.0);
+        auto emitSample = [&](const Eigen::VectorXd& solution, double time) {
+            std::copy_n(solution.data(), nodeUnknowns, row.begin());
+            sink.consume(time, row);
+        };
+
+        emitSample(steadyState, 0.0);
+
+        if (!options.adaptive) {
+            // For a fixed timestep the companion conductances never change (Gear-2 changes once, after its
+            // Backward Euler start), so every step only rebuilds the history currents on the RHS.
+            for (std::int64_t step = 1; step <= steps; ++step) {
+                emitSample(system.advance(timestepSeconds), static_cast<double>(step) * timestepSeconds);
+                system.commit();
+            }
+            statistics.acceptedSteps = static_cast<std::size_t>(steps);
+            statistics.factorizations = system.factorizations();
+            return statistics;
+        }
+
+        const double endTime = static_cast<double>(steps) * timestepSeconds;
+        const double maxStep = options.maxTimestepSeconds > 0.0 ? options.maxTimestepSeconds : durationSeconds / 10.0;
+        const double minStep = std::min(maxStep,
+            options.minTimestepSeconds > 0.0 ? options.minTimestepSeconds : timestepSeconds * 1e-4);
+        const double timeEpsilon = endTime * 1e-12;
+        const double errorExponent = 1.0 / static_cast<double>(system.order() + 1);
+
+        double time = 0.0;
+        double step = std::clamp(timestepSeconds * 0.1, minStep, maxStep);
+        Eigen::VectorXd previous = steadyState;
+        std::int64_t nextOutput = 1;
+
+        while (time < endTime - timeEpsilon) {
+            const double remaining = endTime - time;
+            // Stretch the last step instead of leaving a sliver shorter than minStep.
+            const double attempt = remaining < step + minStep ? remaining : step;
+            const Eigen::VectorXd& candidate = system.advance(attempt);
+
+            const double ratio = system.errorRatio(options.relativeTolerance, options.absoluteTolerance);
+            // A step already at the floor is accepted even when stretched over the remainder; rejecting it
+            // would retry the same stretched attempt forever.
+            if (ratio > 1.0 && step > minStep) {
+                // Shrink from the smaller of the two so a stretched attempt cannot grow the step back.
+                step = std::max(minStep,
+                    std::min(step, attempt) * std::max(0.2, 0.9 * std::pow(ratio, -errorExponent)));
+                ++statistics.rejectedSteps;
+                continue;
+            }
+
+            system.commit();
+            ++statistics.acceptedSteps;
+            const double reached = time + attempt;
+
+            // Interpolate onto the output grid between the two accepted points.
+            while (nextOutput <= steps) {
+                const double outputTime = static_cast<double>(nextOutput) * timestepSeconds;
+                if (outputTime > reached + timeEpsilon) {
+                    break;
+                }
+                const double weight = std::clamp((outputTime - time) / attempt, 0.0, 1.0);
+                for (std::size_t i = 0; i < nodeUnknowns; ++i) {
+                    const auto idx = static_cast<Eigen::Index>(i);
+                    row[i] = previous(idx) + weight * (candidate(idx) - previous(idx));
+                }
+                sink.consume(outputTime, row);
+                ++nextOutput;
+            }
+
+            previous = candidate;
+            time = reached;
+
+            // Every step size change costs a numeric refactorization, so only grow when it pays off.
+            const double growth = ratio > 0.0 ? std::min(2.0, 0.9 * std::pow(ratio, -errorExponent)) : 2.0;
+            if (growth > 1.25 || growth < 1.0) {
+                step = std::clamp(attempt * growth, minStep, maxStep);
+            }
+        }
+
+        statistics.factorizations = system.factorizations();
+        return statistics;
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef CIRCUITX_TRANSIENTINTEGRATOR_H
+#define CIRCUITX_TRANSIENTINTEGRATOR_H
+
+#include "CompanionSystem.h"
+
+#include <circuitx/transient.hpp>
+
+namespace circuitx {
+    /**
+     * Steps a seeded companion system from t = 0 to options.durationSeconds and hands the node rows
+     * of the output grid (k * timestepSeconds, t = 0 included) to sink.consume(). A fixed step only
+     * rebuilds the history currents; adaptive stepping controls the capacitor LTE and interpolates
+     * the accepted points onto the grid. begin()/end() are left to the caller. Each row has
+     * `columns` values: the leading node unknowns of the solution followed by ground (0).
+     * The options must pass validTransientOptions().
+     */
+    TransientStatistics integrateTransient(CompanionSystem& system,
+        const Eigen::VectorXd& steadyState,
+        const TransientOptions& options,
+        std::size_t columns,
+        TransientSink& sink);
+
+    // Positive duration and timestep; adaptive runs also need positive tolerances.
+    [[nodiscard]] bool validTransientOptions(const TransientOptions& options);
+
+    // Output grid points including t = 0.
+    [[nodiscard]] std::size_t transientSampleCount(const TransientOptions& options);
+}
+
+#endif //CIRCUITX_TRANSIENTINTEGRATOR_H
@@ -0,0 +1,128 @@
+#include <circuitx/transient.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+
+namespace circuitx {
+    namespace {
+        constexpr char kBinaryMagic[4] = {'C', 'X', 'T', 'R'};
+        constexpr std::uint32_t kBinaryVersion = 1;
+
+        template<typename T>
+        void writeRaw(std::ofstream& out, const T& value) {
+            static_assert(sizeof(T) == 4 || sizeof(T) == 8);
+            using Bits = std::conditional_t<sizeof(T) == 8, std::uint64_t, std::uint32_t>;
+            auto bits = std::bit_cast<Bits>(value);
+            if constexpr (std::endian::native == std::endian::big) {
+                bits = std::byteswap(bits);
+            }
+            out.write(reinterpret_cast<const char*>(&bits), sizeof(bits));
+        }
+    }
+
+    struct BinaryFileSink::Stream {
+        std::ofstream out;
+        std::streampos countOffset{};
+    };
+
+    void TransientCollector::begin(const TransientLayout& layout) {
+        collected = TransientResult{};
+        collected.solved = true;
+        collected.timestep = layout.timestep;
+        collected.referenceNodeId = layout.referenceNodeId;
+        collected.nodeIds = layout.nodeIds;
+        collected.nodeIndex = layout.nodeIndex;
+        collected.times.reserve(layout.expectedSamples);
+        collected.samples.reserve(layout.expectedSamples * layout.nodeIds.size());
+    }
+
+    void TransientCollector::consume(double time, std::span<const double> values) {
+        collected.times.push_back(time);
+        collected.samples.insert(collected.samples.end(), values.begin(), values.end());
+    }
+
+    DecimatingSink::DecimatingSink(TransientSink& downstream, std::size_t every)
+        : downstream(downstream), every(std::max<std::size_t>(every, 1)) {}
+
+    void DecimatingSink::begin(const TransientLayout& layout) {
+        seen = 0;
+        lastForwarded = false;
+        lastValues.assign(layout.nodeIds.size(), 0.0);
+
+        TransientLayout decimated = layout;
+        decimated.timestep = layout.timestep * static_cast<double>(every);
+        decimated.expectedSamples = layout.expectedSamples / every + 2;
+        downstream.begin(decimated);
+    }
+
+    void DecimatingSink::consume(double time, std::span<const double> values) {
+        lastForwarded = seen % every == 0;
+        ++seen;
+        if (lastForwarded) {
+            downstream.consume(time, values);
+            return;
+        }
+        lastTime = time;
+        std::copy(values.begin(), values.end(), lastValues.begin());
+    }
+
+    void DecimatingSink::end() {
+        // Keep the final state of the run even when it does not fall on the stride.
+        if (seen > 0 && !lastForwarded) {
+            downstream.consume(lastTime, lastValues);
+        }
+        downstream.end();
+    }
+
+    BinaryFileSink::BinaryFileSink(std::string path) : path(std::move(path)) {}
+
+    BinaryFileSink::~BinaryFileSink() = default;
+
+    void BinaryFileSink::begin(const TransientLayout& layout) {
+        stream = std::make_unique<Stream>();
+        std::ofstream& out = stream->out;
+        out.open(path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Could not open " + path + " for writing");
+        }
+        written = 0;
+
+        out.write(kBinaryMagic, sizeof(kBinaryMagic));
+        writeRaw(out, kBinaryVersion);
+        writeRaw(out, static_cast<std::uint64_t>(layout.nodeIds.size()));
+        stream->countOffset = out.tellp();
+        writeRaw(out, std::uint64_t{0});
+        writeRaw(out, layout.timestep);
+        writeRaw(out, static_cast<std::uint32_t>(layout.referenceNodeId));
+        for (unsigned int id : layout.nodeIds) {
+            writeRaw(out, static_cast<std::uint32_t>(id));
+        }
+    }
+
+    void BinaryFileSink::consume(double time, std::span<const double> values) {
+        std::ofstream& out = stream->out;
+        writeRaw(out, time);
+        if constexpr (std::endian::native == std::endian::little) {
+            out.write(reinterpret_cast<const char*>(values.data()),
+                static_cast<std::streamsize>(values.size_bytes()));
+        } else {
+            for (double value : values) {
+                writeRaw(out, value);
+            }
+        }
+        ++written;
+    }
+
+    void BinaryFileSink::end() {
+        std::ofstream& out = stream->out;
+        out.seekp(stream->countOffset);
+        writeRaw(out, written);
+        out.close();
+        if (out.fail()) {
+            throw std::runtime_error("Failed to write " + path);
+        }
+    }
+}
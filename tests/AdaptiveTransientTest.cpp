@@ -0,0 +1,81 @@
+#include <circuitx/circuit.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace circuitx;
+
+namespace {
+    int failures = 0;
+
+    void check(bool condition, const char* what) {
+        if (!condition) {
+            std::fprintf(stderr, "FAILED: %s\n", what);
+            ++failures;
+        }
+    }
+
+    // R1 1-0, R2 2-1, C 2-0 driven by a current source into node 1.
+    Circuit rcDivider() {
+        Circuit circuit;
+        for (unsigned int id = 0; id < 3; ++id) {
+            circuit.addNode({id, "n" + std::to_string(id)});
+        }
+        circuit.addElement(Res{1, 0, 100.0f});
+        circuit.addElement(Res{2, 1, 100.0f});
+        circuit.addElement(Cap{2, 0, 1e-6f});
+        circuit.addElement(ISource{0, 1, 1e-3f});
+        return circuit;
+    }
+
+    TransientOptions tightOptions(IntegrationMethod method, double tolerance) {
+        TransientOptions options;
+        options.durationSeconds = 1e-3;
+        options.timestepSeconds = 1e-4;
+        options.minTimestepSeconds = 3e-5;
+        options.method = method;
+        options.adaptive = true;
+        options.relativeTolerance = tolerance;
+        options.absoluteTolerance = tolerance;
+        return options;
+    }
+
+    // The last step is stretched over a remainder between minStep and 2 * minStep; a rejected step at the
+    // floor used to retry that same stretched step forever.
+    void tightTolerancesReachEndTime() {
+        for (IntegrationMethod method : {IntegrationMethod::BackwardEuler, IntegrationMethod::Trapezoidal,
+                 IntegrationMethod::Gear2}) {
+            for (double tolerance : {1e-18, 1e-300}) {
+                Circuit circuit = rcDivider();
+                const TransientResult result = circuit.simulateTransient(tightOptions(method, tolerance));
+                check(result.solved, "adaptive transient with tight tolerances solves");
+                check(result.sampleCount() == 11, "adaptive transient emits every output grid sample");
+                check(!result.times.empty() && std::abs(result.times.back() - 1e-3) < 1e-12,
+                    "adaptive transient reaches the end time");
+            }
+        }
+    }
+
+    void nonPositiveTolerancesAreRejected() {
+        Circuit circuit = rcDivider();
+        TransientOptions options = tightOptions(IntegrationMethod::Trapezoidal, 1e-6);
+        options.relativeTolerance = 0.0;
+        options.absoluteTolerance = 0.0;
+        check(!circuit.simulateTransient(options).solved, "zero tolerances are rejected");
+
+        options.relativeTolerance = 1e-3;
+        options.absoluteTolerance = -1e-6;
+        check(!circuit.simulateTransient(options).solved, "a negative tolerance is rejected");
+
+        options.adaptive = false;
+        check(circuit.simulateTransient(options).solved, "tolerances are ignored by fixed-step runs");
+    }
+}
+
+int main() {
+    tightTolerancesReachEndTime();
+    nonPositiveTolerancesAreRejected();
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
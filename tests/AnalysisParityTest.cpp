@@ -0,0 +1,328 @@
+#include <circuitx/circuit.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <numbers>
+#include <string>
+#include <unordered_map>
+
+using namespace circuitx;
+
+namespace {
+    int failures = 0;
+
+    void check(bool condition, const char* what) {
+        if (!condition) {
+            std::fprintf(stderr, "FAILED: %s\n", what);
+            ++failures;
+        }
+    }
+
+    // V 1-0, resistor ladder over nodes 1..4, I 0-4 and a capacitor (open at DC) on node 4.
+    Circuit ladder() {
+        Circuit circuit;
+        for (unsigned int id = 0; id < 5; ++id) {
+            circuit.addNode({id, "n" + std::to_string(id)});
+        }
+        circuit.addElement(VSource{1, 0, 5.0f});     // 0
+        circuit.addElement(Res{1, 2, 100.0f});       // 1
+        circuit.addElement(Res{2, 0, 200.0f});       // 2
+        circuit.addElement(Res{2, 3, 150.0f});       // 3
+        circuit.addElement(Res{3, 0, 300.0f});       // 4
+        circuit.addElement(Res{3, 4, 50.0f});        // 5
+        circuit.addElement(Res{4, 0, 250.0f});       // 6
+        circuit.addElement(ISource{0, 4, 2e-3f});    // 7
+        circuit.addElement(Cap{4, 0, 1e-6f});        // 8
+        return circuit;
+    }
+
+    // side x side resistor mesh, every node tied to ground, fed by current sources: symmetric positive definite.
+    Circuit mesh(int side) {
+        Circuit circuit;
+        auto id = [side](int row, int column) { return static_cast<unsigned int>(1 + row * side + column); };
+        circuit.addNode({0, "gnd"});
+        for (int row = 0; row < side; ++row) {
+            for (int column = 0; column < side; ++column) {
+                circuit.addNode({id(row, column), "n" + std::to_string(id(row, column))});
+            }
+        }
+        for (int row = 0; row < side; ++row) {
+            for (int column = 0; column < side; ++column) {
+                if (column + 1 < side) {
+                    circuit.addElement(Res{id(row, column), id(row, column + 1), 10.0f + static_cast<float>(row)});
+                }
+                if (row + 1 < side) {
+                    circuit.addElement(Res{id(row, column), id(row + 1, column), 20.0f + static_cast<float>(column)});
+                }
+                circuit.addElement(Res{id(row, column), 0, 1000.0f});
+            }
+        }
+        circuit.addElement(ISource{0, id(0, 0), 1e-2f});
+        circuit.addElement(ISource{0, id(side - 1, side - 1), 5e-3f});
+        return circuit;
+    }
+
+    std::unordered_map<unsigned int, double> nodeVoltages(Circuit& circuit, const Eigen::VectorXd& solution) {
+        std::unordered_map<unsigned int, double> voltages;
+        const auto& ordering = circuit.solutionNodeOrdering();
+        for (std::size_t i = 0; i < ordering.size(); ++i) {
+            voltages[ordering[i]] = solution(static_cast<Eigen::Index>(i));
+        }
+        voltages[circuit.solutionGround()] = 0.0;
+        return voltages;
+    }
+
+    double maxDifference(const Eigen::VectorXd& a, const Eigen::VectorXd& b) {
+        return a.size() != b.size() ? INFINITY : a.size() == 0 ? 0.0 : (a - b).cwiseAbs().maxCoeff();
+    }
+
+    // Every sweep point equals a fresh solve() with that value set.
+    void sweepMatchesSolve() {
+        for (std::size_t element : {std::size_t{3}, std::size_t{0}}) {
+            Circuit circuit = ladder();
+            const DcSweep sweep = element == 0 ? DcSweep::linear(element, 1.0, 5.0, 1.0)
+                                               : DcSweep::linear(element, 50.0, 300.0, 50.0);
+            const DcSweepResult result = circuit.sweepDc(sweep);
+            check(result.solved && result.pointCount() == sweep.values.size(), "DC sweep solves every point");
+
+            double difference = 0.0;
+            for (std::size_t p = 0; p < sweep.values.size(); ++p) {
+                Circuit fresh = ladder();
+                fresh.setElementValue(element, static_cast<float>(sweep.values[p]));
+                for (const auto& [id, voltage] : nodeVoltages(fresh, fresh.solve())) {
+                    const auto series = result.seriesForNode(id);
+                    difference = series ? std::max(difference, std::abs((*series)[p] - voltage)) : INFINITY;
+                }
+            }
+            check(difference < 1e-9, "DC sweep points match fresh solves");
+        }
+        check(DcSweep::linear(0, 0.0, 10.0, 1e-9).values.empty(), "an oversized sweep is refused");
+    }
+
+    // Low-rank and refactored what-if solves equal a fresh solve() with the changes applied.
+    void whatIfMatchesSolve() {
+        const std::vector<ValueChange> changes{{1, 120.0}, {4, 80.0}, {7, 3e-3}};
+        Circuit expected = ladder();
+        for (const ValueChange& change : changes) {
+            expected.setElementValue(change.elementIndex, static_cast<float>(change.value));
+        }
+        const Eigen::VectorXd reference = expected.solve();
+
+        for (std::size_t maxRank : {std::size_t{16}, std::size_t{1}}) {
+            Circuit circuit = ladder();
+            circuit.solve();
+            WhatIfOptions options;
+            options.maxRank = maxRank;
+            const WhatIfResult result = circuit.solveWhatIf(changes, options);
+            check(result.solved, "what-if solves");
+            check(result.method == (maxRank == 1 ? WhatIfMethod::Refactored : WhatIfMethod::LowRank),
+                "what-if picks the low-rank update only within maxRank");
+            check(maxDifference(result.solution, reference) < 1e-9, "what-if matches a fresh solve");
+        }
+    }
+
+    // Every fault's deltas equal a fresh solve() with the element replaced by the fault resistance.
+    void faultsMatchSolve() {
+        Circuit nominal = ladder();
+        const auto base = nodeVoltages(nominal, nominal.solve());
+        FaultOptions options;
+        const FaultResult result = nominal.simulateFaults(options);
+        check(result.solved && result.faults.size() == 14, "every resistor and capacitor is opened and shorted");
+
+        double difference = 0.0;
+        for (std::size_t f = 0; f < result.faults.size(); ++f) {
+            const FaultReport& fault = result.faults[f];
+            Circuit faulted = ladder();
+            const double resistance = fault.kind == FaultKind::Open ? options.openResistance : options.shortResistance;
+            Element& element = faulted.elementsMutable()[fault.elementIndex];
+            std::visit([&](const auto& component) { element = Res{component.a, component.b, static_cast<float>(resistance)}; },
+                Element(element));
+            const auto voltages = nodeVoltages(faulted, faulted.solve());
+            const auto deltas = result.deltasForFault(f);
+            for (std::size_t c = 0; c < result.nodeCount(); ++c) {
+                const unsigned int id = result.nodeIds[c];
+                difference = std::max(difference, std::abs(deltas[c] - (voltages.at(id) - base.at(id))));
+            }
+        }
+        check(difference < 1e-6, "fault deltas match fresh solves");
+    }
+
+    // Adjoint derivatives agree with central differences of fresh solves.
+    void sensitivityMatchesDifferences() {
+        Circuit circuit = ladder();
+        SensitivityOptions options;
+        options.outputNodeId = 3;
+        const SensitivityResult result = circuit.analyzeSensitivity(options);
+        check(result.solved && result.elements.size() == 8, "sensitivity covers every resistor and source");
+
+        auto output = [](std::size_t element, float value) {
+            Circuit perturbed = ladder();
+            perturbed.setElementValue(element, value);
+            return nodeVoltages(perturbed, perturbed.solve()).at(3);
+        };
+        for (const ElementSensitivity& sensitivity : result.elements) {
+            const auto value = static_cast<float>(sensitivity.value);
+            const float up = value * 1.01f;
+            const float down = value * 0.99f;
+            const double difference = (output(sensitivity.elementIndex, up) - output(sensitivity.elementIndex, down))
+                / (static_cast<double>(up) - static_cast<double>(down));
+            check(std::abs(difference - sensitivity.derivative) <= 1e-3 * std::max(std::abs(difference), 1e-9),
+                "adjoint derivative matches the central difference");
+        }
+    }
+
+    // Parallel R and C driven by a current source: |V| = I R / sqrt(1 + (wRC)^2), phase = -atan(wRC).
+    void acMatchesAnalyticRc() {
+        Circuit circuit;
+        circuit.addNode({0, "gnd"});
+        circuit.addNode({1, "out"});
+        circuit.addElement(Res{1, 0, 100.0f});
+        circuit.addElement(Cap{1, 0, 1e-6f});
+        circuit.addElement(ISource{0, 1, 1e-3f});
+
+        AcOptions options;
+        options.startHz = 10.0;
+        options.stopHz = 1e5;
+        const AcResult result = circuit.analyzeAc(options);
+        check(result.solved && result.pointCount() == 81, "AC sweep solves the logarithmic grid");
+
+        const double resistance = 100.0;
+        const auto capacitance = static_cast<double>(1e-6f);
+        const auto current = static_cast<double>(1e-3f);
+        const auto column = result.columnForNode(1);
+        double magnitudeError = 0.0;
+        double phaseError = 0.0;
+        for (std::size_t p = 0; column && p < result.pointCount(); ++p) {
+            const double wrc = 2.0 * std::numbers::pi * result.frequencies[p] * resistance * capacitance;
+            const double magnitude = current * resistance / std::sqrt(1.0 + wrc * wrc);
+            const double phase = -std::atan(wrc) * 180.0 / std::numbers::pi;
+            magnitudeError = std::max(magnitudeError, std::abs(result.magnitudeSeries(*column)[p] - magnitude) / magnitude);
+            phaseError = std::max(phaseError, std::abs(result.phaseSeries(*column)[p] - phase));
+        }
+        check(column && magnitudeError < 1e-9, "AC magnitude matches the analytic RC");
+        check(column && phaseError < 1e-7, "AC phase matches the analytic RC");
+
+        options.pointsPerDecade = 1000000000;
+        check(!circuit.analyzeAc(options).solved, "an oversized AC grid is refused");
+    }
+
+    // Thread count never changes the statistics; the Cholesky path agrees with LU.
+    void monteCarloIsDeterministic() {
+        MonteCarloOptions options;
+        options.trials = 2000;
+        Circuit circuit = mesh(6);
+        options.threads = 1;
+        const MonteCarloResult single = circuit.runMonteCarlo(options);
+        check(single.solved && single.failedTrials == 0, "Monte Carlo solves every trial");
+
+        auto identical = [](const MonteCarloResult& a, const MonteCarloResult& b) {
+            if (a.nodes.size() != b.nodes.size()) {
+                return false;
+            }
+            for (std::size_t i = 0; i < a.nodes.size(); ++i) {
+                if (a.nodes[i].mean != b.nodes[i].mean || a.nodes[i].stddev != b.nodes[i].stddev
+                    || a.nodes[i].min != b.nodes[i].min || a.nodes[i].max != b.nodes[i].max
+                    || a.nodes[i].histogram != b.nodes[i].histogram) {
+                    return false;
+                }
+            }
+            return true;
+        };
+        for (unsigned threads : {2u, 5u}) {
+            options.threads = threads;
+            check(identical(circuit.runMonteCarlo(options), single), "Monte Carlo is identical for every thread count");
+        }
+
+        SolverOptions lu;
+        lu.useCholesky = false;
+        circuit.setSolverOptions(lu);
+        options.threads = 1;
+        const MonteCarloResult factoredLu = circuit.runMonteCarlo(options);
+        double difference = 0.0;
+        for (std::size_t i = 0; i < single.nodes.size() && i < factoredLu.nodes.size(); ++i) {
+            difference = std::max({difference, std::abs(single.nodes[i].mean - factoredLu.nodes[i].mean),
+                std::abs(single.nodes[i].stddev - factoredLu.nodes[i].stddev)});
+        }
+        check(factoredLu.nodes.size() == single.nodes.size() && difference < 1e-9,
+            "Monte Carlo with Cholesky matches LU");
+    }
+
+    Eigen::VectorXd solveWith(Circuit circuit, const SolverOptions& options, SolverStatistics* statistics = nullptr) {
+        circuit.setSolverOptions(options);
+        Eigen::VectorXd solution = circuit.solve();
+        if (statistics) {
+            *statistics = circuit.lastSolveStatistics();
+        }
+        return solution;
+    }
+
+    // Every backend, factorization, ordering and preconditioner solves to the dense LU reference.
+    void backendsAgree() {
+        for (int side : {6, 20}) {
+            const Circuit circuit = mesh(side);
+            SolverOptions dense;
+            dense.backend = MatrixBackend::Dense;
+            dense.useCholesky = false;
+            const Eigen::VectorXd reference = solveWith(circuit, dense);
+            const double scale = reference.cwiseAbs().maxCoeff();
+
+            SolverOptions sparse;
+            sparse.backend = MatrixBackend::Sparse;
+            for (bool cholesky : {false, true}) {
+                sparse.useCholesky = cholesky;
+                for (FillOrdering ordering : {FillOrdering::Automatic, FillOrdering::Natural, FillOrdering::Amd,
+                         FillOrdering::Colamd, FillOrdering::NestedDissection}) {
+                    sparse.ordering = ordering;
+                    SolverStatistics statistics;
+                    const Eigen::VectorXd solution = solveWith(circuit, sparse, &statistics);
+                    check(maxDifference(solution, reference) < 1e-9 * scale, "sparse orderings match dense LU");
+                    check(statistics.symmetric == cholesky, "the SPD mesh takes the Cholesky path when enabled");
+                }
+            }
+
+            SolverOptions general = sparse;
+            general.factorization = SparseFactorization::GeneralLu;
+            general.useCholesky = false;
+            check(maxDifference(solveWith(circuit, general), reference) < 1e-9 * scale, "SparseLU matches dense LU");
+
+            SolverOptions cholesky = dense;
+            cholesky.useCholesky = true;
+            check(maxDifference(solveWith(circuit, cholesky), reference) < 1e-9 * scale, "dense LL^T matches dense LU");
+
+            SolverOptions iterative;
+            iterative.backend = MatrixBackend::Iterative;
+            for (PreconditionerType preconditioner : {PreconditionerType::Jacobi, PreconditionerType::IncompleteCholesky,
+                     PreconditionerType::AlgebraicMultigrid}) {
+                iterative.iterative.preconditioner = preconditioner;
+                SolverStatistics statistics;
+                const Eigen::VectorXd solution = solveWith(circuit, iterative, &statistics);
+                check(statistics.iterative && statistics.converged, "CG converges on the SPD mesh");
+                check(maxDifference(solution, reference) < 1e-7 * scale, "CG matches dense LU");
+            }
+        }
+
+        // Voltage sources make the ladder unsymmetric; the iterative backend falls back to sparse LU.
+        const Circuit unsymmetric = ladder();
+        SolverOptions dense;
+        dense.backend = MatrixBackend::Dense;
+        const Eigen::VectorXd reference = solveWith(unsymmetric, dense);
+        for (MatrixBackend backend : {MatrixBackend::Sparse, MatrixBackend::Iterative}) {
+            SolverOptions options;
+            options.backend = backend;
+            check(maxDifference(solveWith(unsymmetric, options), reference) < 1e-9, "unsymmetric backends match dense");
+        }
+    }
+}
+
+int main() {
+    sweepMatchesSolve();
+    whatIfMatchesSolve();
+    faultsMatchSolve();
+    sensitivityMatchesDifferences();
+    acMatchesAnalyticRc();
+    monteCarloIsDeterministic();
+    backendsAgree();
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,129 @@
+#include <circuitx/circuit.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace circuitx;
+
+namespace {
+    int failures = 0;
+
+    void check(bool condition, const char* what) {
+        if (!condition) {
+            std::fprintf(stderr, "FAILED: %s\n", what);
+            ++failures;
+        }
+    }
+
+    // R1 1-0, R2 2-1, C 2-0 driven by a current source into node 1.
+    Circuit rcDivider() {
+        Circuit circuit;
+        for (unsigned int id = 0; id < 3; ++id) {
+            circuit.addNode({id, "n" + std::to_string(id)});
+        }
+        circuit.addElement(Res{1, 0, 100.0f});
+        circuit.addElement(Res{2, 1, 100.0f});
+        circuit.addElement(Cap{2, 0, 1e-6f});
+        circuit.addElement(ISource{0, 1, 1e-3f});
+        SolverOptions solverOptions;
+        solverOptions.backend = MatrixBackend::Sparse;
+        circuit.setSolverOptions(solverOptions);
+        return circuit;
+    }
+
+    double maxDifference(const EnsembleResult& a, const EnsembleResult& b) {
+        if (a.waveforms.size() != b.waveforms.size()) {
+            return INFINITY;
+        }
+        double difference = 0.0;
+        for (std::size_t i = 0; i < a.waveforms.size(); ++i) {
+            difference = std::max(difference, std::abs(a.waveforms[i] - b.waveforms[i]));
+        }
+        return difference;
+    }
+
+    // A member with R2 = 0 leaves node 2 floating at DC. Its lane fails the shared pivot sequence and its own
+    // scalar factorization; that must not disturb the other lanes, and the member reruns on its own.
+    void singularMemberFallsBack() {
+        Circuit circuit = rcDivider();
+        EnsembleOptions options;
+        options.transient.durationSeconds = 1e-4;
+        options.transient.timestepSeconds = 1e-5;
+        options.threads = 1;
+        for (int m = 0; m < 8; ++m) {
+            options.members.push_back({{1, m == 5 ? 0.0 : 100.0 + 10.0 * m}});
+        }
+
+        const EnsembleResult scalar = circuit.simulateEnsemble(options);
+        check(scalar.solved && scalar.failedMembers == 0, "scalar ensemble solves every member");
+
+        for (unsigned lanes : {4u, 8u}) {
+            options.simdLanes = lanes;
+            const EnsembleResult batched = circuit.simulateEnsemble(options);
+            check(batched.solved && batched.failedMembers == 0, "lane ensemble solves every member");
+            check(batched.laneBatchedMembers == 7, "only the singular member leaves its lane group");
+            check(maxDifference(batched, scalar) < 1e-9, "lane waveforms match the scalar waveforms");
+        }
+    }
+
+    void partialGroupMatchesScalar() {
+        Circuit circuit = rcDivider();
+        EnsembleOptions options;
+        options.transient.durationSeconds = 2e-4;
+        options.transient.timestepSeconds = 1e-5;
+        options.transient.method = IntegrationMethod::Trapezoidal;
+        for (int m = 0; m < 11; ++m) {
+            options.members.push_back({{0, 90.0 + 2.0 * m}, {2, 1e-6 * (1.0 + 0.05 * m)}});
+        }
+
+        const EnsembleResult scalar = circuit.simulateEnsemble(options);
+        options.simdLanes = 8;
+        const EnsembleResult batched = circuit.simulateEnsemble(options);
+        check(batched.laneBatchedMembers == options.members.size(), "every member runs in a lane group");
+        check(maxDifference(batched, scalar) < 1e-9, "partial lane group matches the scalar waveforms");
+    }
+
+    // Members that zero a capacitor (or give a zero one a value) change which capacitors carry history; every
+    // lane must still pair each capacitance with its own terminals.
+    void zeroedCapacitorMatchesScalar() {
+        Circuit circuit;
+        for (unsigned int id = 0; id < 3; ++id) {
+            circuit.addNode({id, "n" + std::to_string(id)});
+        }
+        circuit.addElement(Res{1, 0, 100.0f});
+        circuit.addElement(Res{2, 1, 100.0f});
+        circuit.addElement(Cap{1, 0, 1e-6f});
+        circuit.addElement(Cap{2, 0, 0.0f});
+        circuit.addElement(ISource{0, 1, 1e-3f});
+        SolverOptions solverOptions;
+        solverOptions.backend = MatrixBackend::Sparse;
+        circuit.setSolverOptions(solverOptions);
+
+        EnsembleOptions options;
+        options.transient.durationSeconds = 1e-4;
+        options.transient.timestepSeconds = 1e-5;
+        options.transient.method = IntegrationMethod::Trapezoidal;
+        options.members.push_back({{2, 0.0}});
+        options.members.push_back({{3, 2e-6}});
+        options.members.push_back({{2, 0.0}, {3, 1e-6}});
+        options.members.push_back({{0, 120.0}});
+
+        options.threads = 1;
+        const EnsembleResult scalar = circuit.simulateEnsemble(options);
+        check(scalar.solved && scalar.failedMembers == 0, "scalar ensemble solves members with zeroed capacitors");
+        options.simdLanes = 4;
+        const EnsembleResult batched = circuit.simulateEnsemble(options);
+        check(batched.solved && batched.failedMembers == 0, "lane ensemble solves members with zeroed capacitors");
+        check(maxDifference(batched, scalar) < 1e-9, "zeroed capacitors match the scalar waveforms");
+    }
+}
+
+int main() {
+    singularMemberFallsBack();
+    partialGroupMatchesScalar();
+    zeroedCapacitorMatchesScalar();
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
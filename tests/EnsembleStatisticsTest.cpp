@@ -0,0 +1,131 @@
+#include <circuitx/circuit.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace circuitx;
+
+namespace {
+    int failures = 0;
+
+    void check(bool condition, const char* what) {
+        if (!condition) {
+            std::fprintf(stderr, "FAILED: %s\n", what);
+            ++failures;
+        }
+    }
+
+    // R1 1-0, R2 2-1, C 2-0 driven by a current source into node 1.
+    Circuit rcDivider() {
+        Circuit circuit;
+        for (unsigned int id = 0; id < 3; ++id) {
+            circuit.addNode({id, "n" + std::to_string(id)});
+        }
+        circuit.addElement(Res{1, 0, 100.0f});
+        circuit.addElement(Res{2, 1, 100.0f});
+        circuit.addElement(Cap{2, 0, 1e-6f});
+        circuit.addElement(ISource{0, 1, 1e-3f});
+        SolverOptions solverOptions;
+        solverOptions.backend = MatrixBackend::Sparse;
+        circuit.setSolverOptions(solverOptions);
+        return circuit;
+    }
+
+    EnsembleOptions spreadMembers(std::size_t count) {
+        EnsembleOptions options;
+        options.transient.durationSeconds = 2e-4;
+        options.transient.timestepSeconds = 1e-5;
+        options.transient.method = IntegrationMethod::Gear2;
+        for (std::size_t m = 0; m < count; ++m) {
+            const double spread = static_cast<double>(m % 7) - 3.0;
+            options.members.push_back({{0, 100.0 + 4.0 * spread}, {2, 1e-6 * (1.0 + 0.03 * spread)}});
+        }
+        return options;
+    }
+
+    double maxDifference(const std::vector<double>& a, const std::vector<double>& b) {
+        if (a.size() != b.size()) {
+            return INFINITY;
+        }
+        double difference = 0.0;
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            difference = std::max(difference, std::abs(a[i] - b[i]));
+        }
+        return difference;
+    }
+
+    // Streaming statistics agree with the statistics of the stored waveforms.
+    void statisticsMatchWaveforms() {
+        Circuit circuit = rcDivider();
+        EnsembleOptions options = spreadMembers(37);
+        const EnsembleResult waveforms = circuit.simulateEnsemble(options);
+        check(waveforms.solved && waveforms.failedMembers == 0, "waveform ensemble solves every member");
+
+        options.output = EnsembleOutput::Statistics;
+        for (unsigned lanes : {0u, 4u}) {
+            options.simdLanes = lanes;
+            const EnsembleResult statistics = circuit.simulateEnsemble(options);
+            check(statistics.solved && statistics.waveforms.empty(), "statistics ensemble keeps no waveforms");
+
+            const std::size_t samples = waveforms.sampleCount();
+            const std::size_t members = waveforms.memberCount();
+            double meanError = 0.0;
+            double stddevError = 0.0;
+            double rangeError = 0.0;
+            for (std::size_t column = 0; column < waveforms.nodeCount(); ++column) {
+                for (std::size_t s = 0; s < samples; ++s) {
+                    double sum = 0.0;
+                    double low = INFINITY;
+                    double high = -INFINITY;
+                    for (std::size_t m = 0; m < members; ++m) {
+                        const double value = waveforms.waveform(m, column)[s];
+                        sum += value;
+                        low = std::min(low, value);
+                        high = std::max(high, value);
+                    }
+                    const double mean = sum / static_cast<double>(members);
+                    double squares = 0.0;
+                    for (std::size_t m = 0; m < members; ++m) {
+                        const double delta = waveforms.waveform(m, column)[s] - mean;
+                        squares += delta * delta;
+                    }
+                    const double stddev = std::sqrt(squares / static_cast<double>(members - 1));
+                    meanError = std::max(meanError, std::abs(statistics.meanSeries(column)[s] - mean));
+                    stddevError = std::max(stddevError, std::abs(statistics.stddevSeries(column)[s] - stddev));
+                    rangeError = std::max({rangeError, std::abs(statistics.minSeries(column)[s] - low),
+                        std::abs(statistics.maxSeries(column)[s] - high)});
+                }
+            }
+            check(meanError < 1e-12, "streaming mean matches the waveforms");
+            check(stddevError < 1e-12, "streaming stddev matches the waveforms");
+            check(rangeError < 1e-12, "streaming min / max match the waveforms");
+        }
+    }
+
+    // Partials are merged in task order, so the thread count must not change a single bit.
+    void statisticsIndependentOfThreads() {
+        Circuit circuit = rcDivider();
+        EnsembleOptions options = spreadMembers(53);
+        options.output = EnsembleOutput::Statistics;
+        options.threads = 1;
+        const EnsembleResult single = circuit.simulateEnsemble(options);
+        for (unsigned threads : {2u, 3u, 8u}) {
+            options.threads = threads;
+            const EnsembleResult parallel = circuit.simulateEnsemble(options);
+            check(maxDifference(parallel.mean, single.mean) == 0.0
+                    && maxDifference(parallel.stddev, single.stddev) == 0.0
+                    && maxDifference(parallel.min, single.min) == 0.0
+                    && maxDifference(parallel.max, single.max) == 0.0,
+                "statistics are identical for every thread count");
+        }
+    }
+}
+
+int main() {
+    statisticsMatchWaveforms();
+    statisticsIndependentOfThreads();
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,88 @@
+#include <circuitx/circuit.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace circuitx;
+
+namespace {
+    int failures = 0;
+
+    void check(bool condition, const char* what) {
+        if (!condition) {
+            std::fprintf(stderr, "FAILED: %s\n", what);
+            ++failures;
+        }
+    }
+
+    bool sameSolution(const Eigen::VectorXd& a, const Eigen::VectorXd& b) {
+        return a.size() == b.size() && (a.size() == 0 || (a - b).cwiseAbs().maxCoeff() < 1e-6);
+    }
+
+    // Wire 1-2 merges node 2 into node 1; R 2-0 is fed by I 0-1.
+    Circuit wiredCircuit(bool withNode2) {
+        Circuit circuit;
+        circuit.addNode({0, "n0"});
+        circuit.addNode({1, "n1"});
+        if (withNode2) {
+            circuit.addNode({2, "n2"});
+        }
+        circuit.addElement(Wire{1, 2});
+        circuit.addElement(Res{2, 0, 100.0f});
+        circuit.addElement(ISource{0, 1, 1e-3f});
+        return circuit;
+    }
+
+    // Removing a wire-merged node changes the terminals the MNA context resolves, even though the united
+    // node list and the raw element terminals stay the same. Node 1 then floats, so only the system size
+    // is compared.
+    void removedSupernodeMemberMissesCache() {
+        Circuit circuit = wiredCircuit(true);
+        const Eigen::VectorXd merged = circuit.solve();
+        check(merged.size() == 1, "wire-merged nodes share one row");
+
+        circuit.removeNode(2);
+        const Eigen::VectorXd edited = circuit.solve();
+        check(!circuit.lastSolveStatistics().reusedTopology, "removing a merged node misses the topology cache");
+
+        Circuit fresh = wiredCircuit(false);
+        check(edited.size() == 2 && edited.size() == fresh.solve().size(),
+            "edited circuit builds the system of a freshly built one");
+    }
+
+    void valueEditReusesCache() {
+        Circuit circuit = wiredCircuit(true);
+        circuit.solve();
+        circuit.setElementValue(1, 200.0f);
+        const Eigen::VectorXd edited = circuit.solve();
+        check(circuit.lastSolveStatistics().reusedTopology, "a value edit reuses the topology cache");
+        check(edited.size() == 1 && std::abs(edited(0) - 0.2) < 1e-6, "a value edit solves with the new value");
+    }
+
+    // Copies share the cache; each must still solve its own topology.
+    void copiesWithDifferentTopologies() {
+        Circuit original = wiredCircuit(true);
+        Circuit copy = original;
+        copy.removeElementsIf([](const Element& element) { return std::holds_alternative<Wire>(element); });
+        copy.addElement(Res{1, 2, 100.0f});
+
+        const Eigen::VectorXd copySolution = copy.solve();
+        const Eigen::VectorXd originalSolution = original.solve();
+        check(!original.lastSolveStatistics().reusedTopology, "a copy's topology is not reused by the original");
+
+        Circuit freshCopy = wiredCircuit(true);
+        freshCopy.removeElementsIf([](const Element& element) { return std::holds_alternative<Wire>(element); });
+        freshCopy.addElement(Res{1, 2, 100.0f});
+        check(sameSolution(copySolution, freshCopy.solve()), "the copy solves its own topology");
+        check(sameSolution(originalSolution, wiredCircuit(true).solve()), "the original solves its own topology");
+    }
+}
+
+int main() {
+    removedSupernodeMemberMissesCache();
+    valueEditReusesCache();
+    copiesWithDifferentTopologies();
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}